@@ -3,33 +3,12 @@
 Agent::Agent(Zobrist* zTables) : mModel(&mAttackTables, zTables)
 {
 	mMaxDepth = 8;
-	mCurrentDepthStart = 1;
 	mZobristTables = zTables;
 	mModel.SetHash(mZobristTables->HashBoard(&mModel));
-	mNodes = 0;
 	mPrincipalVariationMove = 0;
 	mBestMoveNegamax = 0;
-	mPly = 0;
 	mOriginalSideToMove = white;
 
-	// initialize the killer moves size
-	int ply = 64;
-	int maxKillerMoves = 2;
-	for (int i = 0; i < maxKillerMoves; i++)
-	{
-		std::vector<unsigned long long> moves(ply, 0);
-		mKillerMoves.push_back(moves);
-	}
-
-	// initialize the history table size
-	int numPieces = 12;
-	int numSquares = 64;
-	for (int i = 0; i < numPieces; i++)
-	{
-		std::vector<int> history(numSquares, 0);
-		mHistoryTable.push_back(history);
-	}
-
 	// initialize the transposition table size
 	mTTSize = 0x1000;
 	for (int i = 0; i < mTTSize; i++)
@@ -39,20 +18,19 @@ Agent::Agent(Zobrist* zTables) : mModel(&mAttackTables, zTables)
 		tt.flags = 0;
 		tt.hash_key = 0;
 		tt.value = 0;
+		tt.move = 0;
 		mTranspositionTable.push_back(tt);
 	}
 	//mTranspositionTable.reserve(mTTSize);
+	mHashTable = mTranspositionTable.data();
 
-	mMaxPvLength = 64;
-	for (int i = 0; i < mMaxPvLength; i++)
-	{
-		std::vector<unsigned long long> moves(mMaxPvLength, 0);
-		mPvTable.push_back(moves);
-		mPvLength.push_back(0);
-	}
-
-	mFollowPvLine = false;
-	mScorePV = false;
+	// single threaded until the "Threads" option says otherwise
+	mThreadCount = 1;
+	mSmpMode = lazySmp;
+	mStopSearch = false;
+	mPonderHit = false;
+	mTimePolicy = DEFAULT_TIME_POLICY;
+	mMultiPv = 1;
 
 
 	InitializeKingBonusPassedPawnTable();
@@ -61,6 +39,14 @@ Agent::Agent(Zobrist* zTables) : mModel(&mAttackTables, zTables)
 	hashEntryCounter = 0;
 }
 
+Agent::~Agent()
+{
+	for (int i = 0; i < mSearchThreads.size(); i++)
+	{
+		delete mSearchThreads[i];
+	}
+}
+
 void Agent::UpdateFromPercepts(Percepts state)
 {
 	mModel.SetBitboards(state.bitboards);
@@ -74,6 +60,8 @@ void Agent::UpdateFromPercepts(Percepts state)
 
 	mOriginalSideToMove = mModel.GetSideToMove();
 
+	// only the game we were just given counts for repetitions
+	mMoveHashesHistory.clear();
 	for (const auto& i : state.movesHistory)
 	{
 		mMoveHashesHistory[i.first] = 1;
@@ -81,10 +69,10 @@ void Agent::UpdateFromPercepts(Percepts state)
 
 }
 
-unsigned long long Agent::RandomAgentFunction()
+Move Agent::RandomAgentFunction()
 {
 	// will pick a random move in the position and return it
-	std::vector<unsigned long long> moves;
+	std::vector<Move> moves;
 	mModel.generateMoves(moves);
 
 	// get index of all legal positions
@@ -106,721 +94,150 @@ unsigned long long Agent::RandomAgentFunction()
 
 
 
-void Agent::PrintMoveScores(std::vector<unsigned long long> const& moves, Node* state)
+void Agent::ClearTranspositionTable()
 {
-	std::cout << "Printing move scores" << std::endl;
-	for (int i = 0; i < moves.size(); i++)
+	//mTranspositionTable.clear();
+	//mTranspositionTable.reserve(mTTSize);
+	for (int i = 0; i < mTTSize; i++)
 	{
-		std::cout << "Move: ";
-		printMove(moves[i]);
-		std::cout << " Score: " << scoreMove(moves[i], state->currentDepth) << std::endl;
+		mHashTable[i].hash_key = 0;
+		mHashTable[i].depth = 0;
+		mHashTable[i].flags = 0;
+		mHashTable[i].value = 0;
+		mHashTable[i].move = 0;
 	}
 }
 
-
-int Agent::scoreMove(int move, int depth)
+SearchResult Agent::SearchNegamax(SearchLimits const& limits)
 {
-	// score capture move
-
-	if (mScorePV)
+	// take the threads for this search out of the pool, the first one owns it
+	std::vector<SearchThread*> helpers;
+	SearchThread* thread = AcquireSearchThread();
+	for (int i = 1; i < mThreadCount; i++)
 	{
-		// make sure we have the right PV move
-		if (mPvTable[0][depth] == move)
-		{
-			// disable the scorePV flag
-			mScorePV = false;
-
-			// return a high priority
-			return 20000;
-		}
+		helpers.push_back(AcquireSearchThread());
 	}
 
-	if (decode_capture_flag(move))
-	{
-		
-		// initialize target piece
-		int target_piece = P;
-
-		// we need to determine which side white/black we need to pop the bit from the bitboard
-		int startPiece, endPiece;
-
-
-		if (mModel.GetSideToMove() == white)
-		{
-			startPiece = p;
-			endPiece = k;
-		}
-		else
-		{
-			startPiece = P;
-			endPiece = K;
-		}
-		std::vector<unsigned long long> bitboards = mModel.GetBitboards();
-		// now loop over the bitboards and clear the bit that had the captured piece
-		for (int i = startPiece; i <= endPiece; i++)
-		{
+	thread->SetPosition(mModel, mMoveHashesHistory);
 
-			if (get_bit(bitboards[i], decode_destination_square(move)))
-			{
-				target_piece = i;
-				break;
-			}
-		}
+	// the table is kept between iterations so that the helper threads can share their work
+	ClearTranspositionTable();
+	SearchResult result = RunSearch(thread, helpers, limits, true);
 
-
-		// score by MVV LVA lookup
-		return mvv_lva[decode_piece_type(move)][target_piece] + 10000;
-	}
-
-	// score quiet move
-	else
-	{
-		// score first killer
-		if (mKillerMoves[0][depth] == move)
-		{
-			return 9000;
-		}
-
-		// score second killer
-		else if (mKillerMoves[1][depth] == move)
-		{
-			return 8000;
-		}
-		else if (decode_castling_flag(move))
-		{
-			// score castling move
-			return 15000;
-		}
-		// score history move
-		else
-		{
-			return mHistoryTable[decode_piece_type(move)][decode_destination_square(move)];
-		}
-	}
-	return 0;
-}
-
-void Agent::OrderMoves(std::vector<unsigned long long>& moves, int depth)
-{
-	// move scores
-	//std::vector<int> movesScores(moves.size(), 0);
-
-	std::vector<MoveScore> moveScores;
-	// score all the moves within a move list
-	// zip up
-	for (int count = 0; count < moves.size(); count++)
+	// a hard time limit leaves the flag raised
+	mStopSearch = false;
+	mPonderHit = false;
+	for (int i = 0; i < helpers.size(); i++)
 	{
-		MoveScore a;
-		a.score = scoreMove(moves[count], depth);
-		a.move = moves[count];
-		moveScores.push_back(a);
-		//movesScores[count] = scoreMove(moves[count], state);
+		ReleaseSearchThread(helpers[i]);
 	}
+	ReleaseSearchThread(thread);
 
-	// sort in descending order
-	std::sort(moveScores.begin(), moveScores.end(), [](const MoveScore a, MoveScore b) {
-		return b < a;
-	});
-
-	// unpack
-	for (int i = 0; i < moves.size(); i++)
-	{
-		moves[i] = moveScores[i].move;
-	}
+	return result;
 }
 
-void Agent::ResetKilleHistoryMoves()
+SearchResult Agent::RunSearch(SearchThread* thread, std::vector<SearchThread*> const& helpers, SearchLimits const& limits, bool uci)
 {
-	// reset the killer moves
-	for (int i = 0; i < mKillerMoves.size(); i++)
+	// every search of the agent is set up here, the caller gives the thread its position and looks after the table
+	thread->SetHelpers(helpers, mSmpMode);
+	thread->SetTimePolicy(mTimePolicy);
+	thread->SetMultiPv(mMultiPv);
+
+	// a UCI search prints its progress and is stopped from the UCI thread, the others keep to the thread's
+	// own flags so that batch workers searching side by side don't stop each other
+	SearchResult result;
+	if (uci)
 	{
-		for (int j = 0; j < mKillerMoves[i].size(); j++)
-		{
-			mKillerMoves[i][j] = 0;
-		}
+		thread->SetStopFlag(&mStopSearch);
+		thread->SetPonderHitFlag(&mPonderHit);
+		result = thread->SearchNegamax(limits);
 	}
-
-	// reset the history table
-	for (int i = 0; i < mHistoryTable.size(); i++)
+	else
 	{
-		for (int j = 0; j < mHistoryTable[i].size(); j++)
-		{
-			mHistoryTable[i][j] = 0;
-		}
+		result = thread->Analyse(limits, false);
 	}
 
+	// the thread goes back to the pool as a thread of its own
+	thread->SetHelpers({}, mSmpMode);
+	thread->SetStopFlag(nullptr);
+	thread->SetPonderHitFlag(nullptr);
+	thread->SetMultiPv(1);
 
+	return result;
 }
 
-void Agent::ResetPVMoves()
-{
-
-	// reset pv length
-	for (int i = 0; i < mPvLength.size(); i++)
-	{
-		mPvLength[i] = 0;
-	}
-
-	// reset pv table
-	for (int i = 0; i < mPvTable.size(); i++)
-	{
-		for (int j = 0; j < mPvTable[i].size(); j++)
-		{
-			mPvTable[i][j] = 0;
-		}
-	}
-}
-
-void Agent::ClearTranspositionTable()
+void Agent::StopSearch()
 {
-	//mTranspositionTable.clear();
-	//mTranspositionTable.reserve(mTTSize);
-	for (int i = 0; i < mTranspositionTable.size(); i++)
-	{
-		mTranspositionTable[i].hash_key = 0;
-		mTranspositionTable[i].depth = 0;
-		mTranspositionTable[i].flags = 0;
-		mTranspositionTable[i].value = 0;
-	}
+	mStopSearch = true;
 }
 
-int Agent::ProbeHash(int alpha, int beta, int depth)
+void Agent::PonderHit()
 {
-	// get the hash entry for the current position if it exists
-	TT_Entry* entry = &mTranspositionTable[mModel.mHash % mTTSize];
-
-	// verify that we have the right position
-	if (entry->hash_key == mModel.mHash)
-	{
-		// verify the depth of the entry
-		if (entry->depth >= depth)
-		{
-			// match what the entry has
-			if (entry->flags == HASH_FLAG_EXACT)
-			{
-				//std::cout << "exact score: " << std::endl;
-				return entry->value;
-			}
-			if ((entry->flags == HASH_FLAG_ALPHA) &&
-				(entry->value <= alpha))
-			{
-				//std::cout << "alpha score: " << std::endl;
-				return alpha;
-			}
-			if ((entry->flags == HASH_FLAG_BETA) &&
-				(entry->value >= beta))
-			{
-				//std::cout << "beta score: " << std::endl;
-				return beta;
-			}
-		}
-	}
-	// return something out of bounds
-	return NO_HASH_ENTRY;
+	mPonderHit = true;
 }
 
-void Agent::RecordHash(int score, int depth, int hashFlag)
+void Agent::ClearStop()
 {
-	// get the correct entry for the hash
-	TT_Entry* entry = &mTranspositionTable[mModel.mHash % mTTSize];
-
-	// write the entry data
-	entry->hash_key = mModel.mHash;
-	entry->value = score;
-	entry->flags = hashFlag;
-	entry->depth = depth;
+	mStopSearch = false;
+	mPonderHit = false;
 }
 
-void Agent::EnablePvScoring(std::vector<unsigned long long> const& moves, int ply)
+SearchThread* Agent::AcquireSearchThread()
 {
-	// disable following PV
-	mFollowPvLine = false;
+	std::lock_guard<std::mutex> guard(mPoolLock);
 
-	// loop over the moves
-	for (int i = 0; i < moves.size(); i++)
+	// reuse an idle thread, its tables are reset by the search anyway
+	if (mIdleSearchThreads.size())
 	{
-		// make sure we hit PV move
-		if (mPvTable[0][ply] == moves[i])
-		{
-			mScorePV = true;
-			mFollowPvLine = true;
-		}
+		SearchThread* thread = mIdleSearchThreads.back();
+		mIdleSearchThreads.pop_back();
+		return thread;
 	}
+
+	SearchThread* thread = new SearchThread(this);
+	mSearchThreads.push_back(thread);
+	return thread;
 }
 
-unsigned long long Agent::SearchNegamax(int depth)
+void Agent::ReleaseSearchThread(SearchThread* thread)
 {
-	int score = 0;
-	mNodes = 0;
-	ResetKilleHistoryMoves();
-	ResetPVMoves();
-	mFollowPvLine = false;
-	mScorePV = false;
-
-	int goalNodesSearched = 3000000;
-
-	// get the time in ms
-	unsigned long long time_start = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-
-
-	for (int i = 1; i <= depth; i++)
-	{
-		//hashEntryCounter = 0;
-		ClearTranspositionTable();
-		ResetKilleHistoryMoves();
-		mNodes = 0;
-		// enable follow PV flag
-		mFollowPvLine = true;
-		mCurrentDepthStart = i;
-
-		score = Negamax(-50000, 50000, i);
-		std::cout << "depth " << i << " score " << score << " nodes " << mNodes << " pv ";
-
-		// loop oever PV line
-		for (int count = 0; count < mPvLength[0]; count++)
-		{
-			printMove(mPvTable[0][count]);
-			std::cout << " ";
-		}
-		std::cout << std::endl;
-
-		// check the time
-		unsigned long long time_end = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-
-
-		// time controls, allow more search depth if done quickly
-		if ((time_end - time_start < 12000 || depth <= 14 ) && i == depth)
-		{
-			depth++;
-		}
-
-		if (mNodes >= goalNodesSearched)
-		{
-			depth--;
-		}
-
-		if (depth == 32)
-		{
-			depth = 0;
-		}
-
-		// if we found a checkmate score for the side to move, we just cut the search early
-		if (score > 45000)
-		{
-			break;
-		}
-	}
-	return mPvTable[0][0];
+	std::lock_guard<std::mutex> guard(mPoolLock);
+	mIdleSearchThreads.push_back(thread);
 }
 
-
-int Agent::Negamax(int alpha, int beta, int depth)
+void Agent::SetThreads(int threads)
 {
-	// define score variable
-	int score;
-
-	// set the hash flag for the transposition table
-	int hashf = HASH_FLAG_ALPHA;
-
-	// read transposition table
-	
-	
-	
-	// transposition table lookup
-	if ((score = ProbeHash(alpha, beta, depth)) != NO_HASH_ENTRY)
-	{
-		// return the value if the position has been searched before
-		//std::cout << "here" << std::endl;
-
-		if (score == 49000)
-			return score - mPly;
-		if (score == -49000)
-			return score + mPly;
-
-		return score;
-	}
-	
-
-	// if this position has been repeated before, return 0 (avoids repeats if winning)
-	if (mMoveHashesHistory.count(mModel.GetHash()) && mPly != 0)
-	{
-		return 0;
-	}
-
-	// init PV length
-	mPvLength[mPly] = mPly;
-
-	// recursion escape condition
-	if (depth == 0 || mPly == 32)
-	{
-		//return EvalNegamax();
-		return QuiescenceNegamax(alpha, beta, depth);
-	}
-
-	// increment nodes count
-	mNodes++;
-
-
-	// number of moves searched in a move list
-	int movesSearched = 0;
-
-	// count the legal moves
-	int legalMoves = 0;
-
-	// in-check state of the side to move
-	int sideToMove = mModel.mSideToMove;
-	unsigned long long kingBitboard = (sideToMove == white) ? mModel.mBitboards[K] : mModel.mBitboards[k];
-	int inCheck = mAttackTables.SquareAttacked(get_LS1B_index(kingBitboard), sideToMove ^ 1,
-		mModel.mBitboards, mModel.mOccupancies);
-
-	if (inCheck)
-	{
-		depth++;
-	}
-	
-	
-	// Null move pruning
-	if (depth >= 3 && !inCheck && mPly && !mModel.OnlyPawns())
-	{
-		// make a null move (switch side to move)
-		// literally give an opponent a free move
-
-		mModel.mSideToMove ^= 1;
-
-		// keep the old enpassant square
-		int oldEnpassant = mModel.mEnPassant;
-
-		// keep the old hash
-		int oldHash = mModel.mHash;
-
-		// undo the enpassant hash
-		if (mModel.mEnPassant != noSquare)
-		{
-			mModel.mHash ^= mZobristTables->mRandomNumberEnpassantTable[mModel.mEnPassant];
-		}
-
-		// reset the enpassant square
-		mModel.mEnPassant = noSquare;
-
-		// re-hash the side change
-		mModel.mHash ^= mZobristTables->mRandomNumberSide;
-
-		// do the search with reduced depth to find beta cutoff
-		// (depth - 1 - R, where R is a reduction limit)
-		score = -Negamax(-beta, -beta + 1, depth - 1 - 2);
-
-		// restore board state
-		mModel.mEnPassant = oldEnpassant;
-		mModel.mHash = oldHash;
-		mModel.mSideToMove ^= 1;
-
-		// fail hard beta cutoff
-		if (score >= beta)
-		{
-			return beta;
-		}
-	}
-	
-	
+	mThreadCount = std::max(1, std::min(threads, MAX_THREADS));
 
-	// create move list instance
-	std::vector<unsigned long long> moves;
-	mModel.generateMoves(moves);
-
-	// If we are on a PV line
-	if (mFollowPvLine)
+	// have the threads ready before the first search
+	std::vector<SearchThread*> threadList;
+	for (int i = 0; i < mThreadCount; i++)
 	{
-		EnablePvScoring(moves, mPly);
-	}
-
-	// sort the moves
-	OrderMoves(moves, mPly);
-
-	for (int count = 0; count < moves.size(); count++)
-	{
-		// increment ply
-		mPly++;
-
-		// make the move
-		mModel.MakeMove(moves[count], allMoves);
-
-		// make sure to make only legal moves
-		if (mModel.IsIllegal())
-		{
-			// take back the move
-			mModel.UnmakeMove(moves[count]);
-			mPly--;
-
-			continue;
-		}
-
-		// increment the number of legal moves counted
-		legalMoves++;
-
-		if (mCurrentDepthStart > 6)
-		{
-			// full depth search
-			if (movesSearched == 0)
-			{
-				// score current move
-				score = -Negamax(-beta, -alpha, depth - 1);
-			}
-			// Late Move Reduction (LMR) assume that the first handfull of moves are the best, search the rest with reduced depth
-			else
-			{
-
-				// condition to consider LMR
-				if (movesSearched >= fullDepthMoves &&
-					depth >= reductionLimit &&
-					inCheck == false && // neither king was put into check
-					mCurrentDepthStart != depth && // root node
-					decode_capture_flag(moves[count]) == 0 && // no captures
-					decode_promoted_piece_type(moves[count]) == 0 && // no promotions
-					mKillerMoves[0][mPly] != moves[count] && // not a killer move
-					mKillerMoves[1][mPly] != moves[count])
-				{
-					// search move with a reduced depth
-					score = -Negamax(-alpha - 1, -alpha, depth - 2);
-				}
-				else
-				{
-					// hack to ensure a full depth search is done
-					score = alpha + 1;
-				}
-
-				// PV search
-				if (score > alpha)
-				{
-					/* Once you've found a move with a score that is between alpha and beta,
-					* the rest of the moves are searched with the goal of proving that they are all bad.
-					* It's possible to do this a bit faster than a search that worries that one
-					* of the remaining moves might be good
-					*/
-
-					score = -Negamax(-alpha - 1, -alpha, depth - 1);
-
-					/* If the algorithm finds out that it was wrong, and that one of the
-					* subsequent moves was better than the first PV move, it has to search again,
-					* in the normal alpha-beta manner. This happens sometimes, and it's a waste of time,
-					* but generally not often enough to counteract the savings gained from doing the
-					* "bad move proof" search referred to earlier.
-					*/
-
-					if ((score > alpha) && (score < beta))
-					{
-						score = -Negamax(-beta, -alpha, depth - 1);
-					}
-				}
-			}
-		}
-		// no late move reductions until iterative deepening reaches > 6
-		// will help the engine to not miss trivial mate in 3's
-		else
-		{
-			// full depth search
-			if (movesSearched == 0)
-			{
-				// score current move
-				score = -Negamax(-beta, -alpha, depth - 1);
-			}
-			else
-			{
-				// PV search
-				if (score > alpha)
-				{
-					score = -Negamax(-alpha - 1, -alpha, depth - 1);
-					if ((score > alpha) && (score < beta))
-					{
-						score = -Negamax(-beta, -alpha, depth - 1);
-					}
-				}
-				else
-				{
-					score = -Negamax(-beta, -alpha, depth - 1);
-				}
-			}
-		}
-
-		
-
-		// decrement ply
-		mPly--;
-
-		// take move back
-		mModel.UnmakeMove(moves[count]);
-
-		// increment number of moves searched
-		movesSearched++;
-
-		// fail-hard beta cutoff
-		if (score >= beta)
-		{
-			// store transposition score with the BETA flag
-			RecordHash(score, depth, HASH_FLAG_BETA);
-
-			if (!decode_capture_flag(moves[count]))
-			{
-				// store the killer move
-				mKillerMoves[1][mPly] = mKillerMoves[0][mPly];
-				mKillerMoves[0][mPly] = moves[count];
-			}
-			// move fails high
-			return beta;
-		}
-
-		if (score > alpha)
-		{
-			// switch to exact flag
-			hashf = HASH_FLAG_EXACT;
-
-			if (!decode_capture_flag(moves[count]))
-			{
-				if (mHistoryTable[decode_piece_type(moves[count])][decode_destination_square(moves[count])] < 7000)
-				{
-					// update the history table
-					mHistoryTable[decode_piece_type(moves[count])][decode_destination_square(moves[count])] += depth;
-				}
-			}
-
-			// PV move
-			alpha = score;
-
-			// write PV move
-			mPvTable[mPly][mPly] = moves[count];
-
-			// loop oever next ply
-			for (int nextPly = mPly + 1; nextPly < mPvLength[mPly + 1]; nextPly++)
-			{
-				// copy move from deeper ply into a current ply's line
-				mPvTable[mPly][nextPly] = mPvTable[mPly + 1][nextPly];
-			}
-
-			// adjust PV length
-			mPvLength[mPly] = mPvLength[mPly + 1];
-		}
+		threadList.push_back(AcquireSearchThread());
 	}
-
-
-	// store the hash
-	RecordHash(alpha, depth, hashf);
-
-	// check if stalemate or checkmate
-	if (legalMoves == 0)
+	for (int i = 0; i < threadList.size(); i++)
 	{
-		if (inCheck)
-		{
-			// checkmate
-			RecordHash(-49000, depth, HASH_FLAG_EXACT);
-			return -49000 + mPly;
-		}
-		else
-		{
-			// stalemate
-			RecordHash(0, depth, HASH_FLAG_EXACT);
-			return 0;
-		}
+		ReleaseSearchThread(threadList[i]);
 	}
-
-	// move fails low
-	return alpha;
 }
 
-int Agent::QuiescenceNegamax(int alpha, int beta, int depth)
+void Agent::SetSmpMode(int mode)
 {
-	mNodes++;
-
-	int score;
-	if ((score = ProbeHash(alpha, beta, depth)) != NO_HASH_ENTRY)
-	{
-		// return the value if the position has been searched before
-		//std::cout << "here" << std::endl;
-
-		if (score == 49000)
-			return score - mPly;
-		if (score == -49000)
-			return score + mPly;
-
-		return score;
-	}
-
-	// evaluate position
-	int standingPat = Evaluate();
-	// fail-hard beta cutoff
-	if (standingPat >= beta)
-	{
-		return beta;
-	}
-
-	if (standingPat > alpha)
-	{
-		alpha = standingPat;
-	}
-
-	
-
-	// create move list instance
-	std::vector<unsigned long long> moves;
-	mModel.generateMoves(moves);
-
-	// sort the moves
-	OrderMoves(moves, mPly);
-
-	for (int count = 0; count < moves.size(); count++)
-	{
-
-		// skip non-capture moves
-		if (!decode_capture_flag(moves[count]) && !decode_promoted_piece_type(moves[count]))
-		{
-			continue;
-		}
-
-
-		// increment ply
-		mPly++;
-
-		// make the move
-		mModel.MakeMove(moves[count], allMoves);
-
-		// make sure to make only legal moves
-		if (mModel.IsIllegal())
-		{
-			// take back the move
-			mModel.UnmakeMove(moves[count]);
-			mPly--;
-
-			continue;
-		}
-
-		// score current move
-		score = -QuiescenceNegamax(-beta, -alpha, depth - 1);
-
-		// decremetn ply
-		mPly--;
-
-		// take move back
-		mModel.UnmakeMove(moves[count]);
-
-
-
-		// fail-hard beta cutoff
-		if (score >= beta)
-		{
-			// move fails high
-			return beta;
-		}
+	mSmpMode = mode;
+}
 
-		if (score > alpha)
-		{
-			// PV move
-			alpha = score;
-		}
-	}
+void Agent::SetTimePolicy(TimePolicy const& policy)
+{
+	mTimePolicy = policy;
+}
 
-	// move fails low
-	return alpha;
+void Agent::SetMultiPv(int lines)
+{
+	mMultiPv = std::max(1, std::min(lines, MAX_MULTI_PV));
 }
 
 
+
 void Agent::InitializeKingBonusPassedPawnTable()
 {
 
@@ -939,7 +356,7 @@ void Agent::InitializeDistanceTables()
 
 
 
-int Agent::Evaluate()
+int Agent::Evaluate(Model& model)
 {
 	//std::vector <int> debugWhite = {};
 	//std::vector <int> debugBlack = {};
@@ -970,15 +387,15 @@ int Agent::Evaluate()
 	int blackControlledSquares = 0;
 
 	// figure out if white/black is castled king or queenside
-	bool blackCastledShort = (mModel.mBitboards[k] & KINGSIDE_CASTLE_SQUARES) > 0;
-	bool whiteCastledShort = (mModel.mBitboards[K] & KINGSIDE_CASTLE_SQUARES) > 0;
+	bool blackCastledShort = (model.mBitboards[k] & KINGSIDE_CASTLE_SQUARES) > 0;
+	bool whiteCastledShort = (model.mBitboards[K] & KINGSIDE_CASTLE_SQUARES) > 0;
 
-	bool blackCastledLong = (mModel.mBitboards[k] & QUEENSIDE_CASLTE_SQUARES) > 0;
-	bool whiteCastledLong = (mModel.mBitboards[K] & QUEENSIDE_CASLTE_SQUARES) > 0;
+	bool blackCastledLong = (model.mBitboards[k] & QUEENSIDE_CASLTE_SQUARES) > 0;
+	bool whiteCastledLong = (model.mBitboards[K] & QUEENSIDE_CASLTE_SQUARES) > 0;
 
 
-	int whiteKingSquare = get_LS1B_index(mModel.mBitboards[K]);
-	int blackKingSquare = get_LS1B_index(mModel.mBitboards[k]);
+	int whiteKingSquare = get_LS1B_index(model.mBitboards[K]);
+	int blackKingSquare = get_LS1B_index(model.mBitboards[k]);
 	unsigned long long whiteKingRing = mAttackTables.mKingAttacks[whiteKingSquare];
 	unsigned long long blackKingRing = mAttackTables.mKingAttacks[blackKingSquare];
 
@@ -988,7 +405,7 @@ int Agent::Evaluate()
 	int blackPassedPawnBonus = 0;
 
 	int notDevelopedPenalty = 25;
-	bool earlyGame = mModel.GetFullMoves() < 20;
+	bool earlyGame = model.GetFullMoves() < 20;
 
 	// init connected pawn variable
 	bool lastPawnWasPassed = false;
@@ -1015,7 +432,7 @@ int Agent::Evaluate()
 
 
 	// loop through the bitboards
-	for (int i = 0; i < mModel.mBitboards.size(); i++)
+	for (int i = 0; i < model.mBitboards.size(); i++)
 	{
 		if (i == K)
 		{
@@ -1023,7 +440,7 @@ int Agent::Evaluate()
 			lastPawnWasPassed = false;
 		}
 
-		bitboardCopy = mModel.mBitboards[i];
+		bitboardCopy = model.mBitboards[i];
 
 		while (bitboardCopy)
 		{
@@ -1036,11 +453,6 @@ int Agent::Evaluate()
 			if (i == P)
 			{
 				whitePawnsCount++;
-				whiteTotal += 100;
-				whiteTotal += pawnWhitePlacementTable[square];
-
-				// calculate distance from center file (get a bonus)
-				whiteTotal += closenessToCenterFileBonus[square];
 
 				// isolated pawns penalty
 
@@ -1056,7 +468,7 @@ int Agent::Evaluate()
 					isolatedBitboard |= fileConstants[file + 1];
 				}
 
-				if ((isolatedBitboard & mModel.mBitboards[P]) == 0)
+				if ((isolatedBitboard & model.mBitboards[P]) == 0)
 				{
 					// isolated pawn detected
 					whiteTotal -= 9;
@@ -1064,7 +476,7 @@ int Agent::Evaluate()
 
 
 				// double pawns penalty
-				if ((mModel.mBitboards[P] & fileConstants[file]) != get_bit(mModel.mBitboards[P], square))
+				if ((model.mBitboards[P] & fileConstants[file]) != get_bit(model.mBitboards[P], square))
 				{
 					whiteTotal -= 3;
 
@@ -1081,7 +493,7 @@ int Agent::Evaluate()
 					pawnDoubled = false;
 				}
 
-				if ((mAttackTables.mPassedPawnMasks[white][square] & mModel.mBitboards[p]) == 0)
+				if ((mAttackTables.mPassedPawnMasks[white][square] & model.mBitboards[p]) == 0)
 				{
 					// passed pawn
 					whitePassedPawnBonus += 30 * rank;
@@ -1091,7 +503,7 @@ int Agent::Evaluate()
 					{
 						// if the doubled pawn is behind, give a negative value
 						// mask the file
-						unsigned long long doubledFile = fileConstants[file] & mModel.mBitboards[P];
+						unsigned long long doubledFile = fileConstants[file] & model.mBitboards[P];
 
 						// get the leading pawn square
 						int pawnSquareInFront = 0;
@@ -1137,14 +549,12 @@ int Agent::Evaluate()
 				attackBitboard = mAttackTables.mPawnAttacks[white][square];
 
 				// connected pawns
-				whiteTotal += countBits((attackBitboard & mModel.mBitboards[P]));
+				whiteTotal += countBits((attackBitboard & model.mBitboards[P]));
 
 			}
 			else if (i == N)
 			{
 				whiteKnightsCount++;
-				whiteTotal += 320;
-				whiteTotal += knightPlacementTable[square];
 
 				tropismToBlackKing += mKnightDistanceTable[square][blackKingSquare];
 
@@ -1162,8 +572,6 @@ int Agent::Evaluate()
 			else if (i == B)
 			{
 				whiteBishopsCount++;
-				whiteTotal += 330;
-				whiteTotal += bishopPlacementTable[square];
 
 				tropismToBlackKing += mRookDistanceTable[square][blackKingSquare];
 
@@ -1175,18 +583,18 @@ int Agent::Evaluate()
 				// stop giving checks in the early game on b5, g5
 				if (earlyGame)
 				{
-					if (square == b5 && get_bit(mModel.mOccupancies[black], c6))
+					if (square == b5 && get_bit(model.mOccupancies[black], c6))
 					{
 						whiteTotal += 2;
 					}
-					if (square == g5 && get_bit(mModel.mOccupancies[black], f6))
+					if (square == g5 && get_bit(model.mOccupancies[black], f6))
 					{
 						whiteTotal += 2;
 					}
 				}
 
 				// don't block the center pawns with the bishop early
-				if ((square == d3 && get_bit(mModel.mBitboards[P], d2)) || (square == e3 && get_bit(mModel.mBitboards[P], e2)))
+				if ((square == d3 && get_bit(model.mBitboards[P], d2)) || (square == e3 && get_bit(model.mBitboards[P], e2)))
 				{
 					whiteTotal -= 8;
 				}
@@ -1195,17 +603,15 @@ int Agent::Evaluate()
 				bishopXrayAttacks = mAttackTables.getBishopAttacks(square, 0);
 
 				// "biting on granite" penalty
-				whiteTotal -= countBits(bishopXrayAttacks & mModel.mBitboards[p]);
+				whiteTotal -= countBits(bishopXrayAttacks & model.mBitboards[p]);
 
-				attackBitboard = mAttackTables.getBishopAttacks(square, mModel.mOccupancies[both]);
+				attackBitboard = mAttackTables.getBishopAttacks(square, model.mOccupancies[both]);
 
 				whiteControlledSquares += countBits(attackBitboard);
 			}
 			else if (i == R)
 			{
 				whiteRooksCount++;
-				whiteTotal += 500;
-				whiteTotal += rookPlacementTable[square];
 
 				tropismToBlackKing += mRookDistanceTable[square][blackKingSquare];
 
@@ -1217,7 +623,7 @@ int Agent::Evaluate()
 				}
 
 				// controlling open files
-				if ((mModel.mBitboards[R] & fileConstants[file]) == (mModel.mOccupancies[both] & fileConstants[file]))
+				if ((model.mBitboards[R] & fileConstants[file]) == (model.mOccupancies[both] & fileConstants[file]))
 				{
 					whiteTotal += 5;
 				}
@@ -1245,7 +651,7 @@ int Agent::Evaluate()
 					// rook pair
 					whiteTotal += 10;
 
-					whiteTotal += ConnectedRooksBonus(rook1, rook2);
+					whiteTotal += ConnectedRooksBonus(model, rook1, rook2);
 
 					if (rookSeventhRankCount >= 2)
 					{
@@ -1253,13 +659,13 @@ int Agent::Evaluate()
 					}
 				}
 
-				attackBitboard = mAttackTables.getRookAttacks(square, mModel.mOccupancies[both]);
+				attackBitboard = mAttackTables.getRookAttacks(square, model.mOccupancies[both]);
 
 
 				// trapped rook
 				if (countBits(attackBitboard) <= 3)
 				{
-					if (square == a1 && get_bit(mModel.mOccupancies[both], a3) || square == h1 && get_bit(mModel.mOccupancies[both], h3))
+					if (square == a1 && get_bit(model.mOccupancies[both], a3) || square == h1 && get_bit(model.mOccupancies[both], h3))
 					{
 						whiteTotal -= 105;
 					}
@@ -1274,8 +680,6 @@ int Agent::Evaluate()
 			else if (i == Q)
 			{
 				whiteQueensCount++;
-				whiteTotal += 900;
-				whiteTotal += queenPlacementTable[square];
 
 				tropismToBlackKing += mQueenDistanceTable[square][blackKingSquare];
 
@@ -1285,7 +689,7 @@ int Agent::Evaluate()
 					whiteTotal -= 10;
 				}
 
-				attackBitboard = mAttackTables.getQueenAttacks(square, mModel.mOccupancies[both]);
+				attackBitboard = mAttackTables.getQueenAttacks(square, model.mOccupancies[both]);
 
 				whiteControlledSquares += countBits(attackBitboard);
 			}
@@ -1293,11 +697,6 @@ int Agent::Evaluate()
 			else if (i == p)
 			{
 				blackPawnsCount++;
-				blackTotal += 100;
-				blackTotal += pawnBlackPlacementTable[square];
-
-				// calculate distance from center file
-				blackTotal += closenessToCenterFileBonus[square];
 
 				// isolated pawns penalty
 				isolatedBitboard = 0;
@@ -1311,14 +710,14 @@ int Agent::Evaluate()
 					isolatedBitboard |= fileConstants[file + 1];
 				}
 
-				if ((isolatedBitboard & mModel.mBitboards[p]) == 0)
+				if ((isolatedBitboard & model.mBitboards[p]) == 0)
 				{
 					// isolated pawn detected
 					blackTotal -= 9;
 				}
 
 				// double pawns penalty
-				if ((mModel.mBitboards[p] & fileConstants[file]) != get_bit(mModel.mBitboards[p], square))
+				if ((model.mBitboards[p] & fileConstants[file]) != get_bit(model.mBitboards[p], square))
 				{
 					blackTotal -= 3;
 
@@ -1335,7 +734,7 @@ int Agent::Evaluate()
 					pawnDoubled = false;
 				}
 
-				if ((mAttackTables.mPassedPawnMasks[black][square] & mModel.mBitboards[P]) == 0)
+				if ((mAttackTables.mPassedPawnMasks[black][square] & model.mBitboards[P]) == 0)
 				{
 
 					// passed pawn
@@ -1347,7 +746,7 @@ int Agent::Evaluate()
 					{
 						// if the doubled pawn is behind, give a negative value
 						// mask the file
-						unsigned long long doubledFile = fileConstants[file] & mModel.mBitboards[p];
+						unsigned long long doubledFile = fileConstants[file] & model.mBitboards[p];
 
 						if (get_LS1B_index(doubledFile) != square)
 						{
@@ -1387,14 +786,12 @@ int Agent::Evaluate()
 				attackBitboard = mAttackTables.mPawnAttacks[black][square];
 
 				// connected pawns
-				blackTotal += countBits(attackBitboard & mModel.mBitboards[p]);
+				blackTotal += countBits(attackBitboard & model.mBitboards[p]);
 
 			}
 			else if (i == n)
 			{
 				blackKnightsCount++;
-				blackTotal += 320;
-				blackTotal += knightPlacementTable[square];
 
 				tropismToWhiteKing += mKnightDistanceTable[square][whiteKingSquare];
 
@@ -1411,8 +808,6 @@ int Agent::Evaluate()
 			else if (i == b)
 			{
 				blackBishopsCount++;
-				blackTotal += 330;
-				blackTotal += bishopPlacementTable[square];
 
 				tropismToWhiteKing += mRookDistanceTable[square][whiteKingSquare];
 
@@ -1422,7 +817,7 @@ int Agent::Evaluate()
 				}
 
 				// don't block the center pawns with the bishop early
-				if ((square == d6 && get_bit(mModel.mBitboards[p], d7)) || (square == e6 && get_bit(mModel.mBitboards[p], e7)))
+				if ((square == d6 && get_bit(model.mBitboards[p], d7)) || (square == e6 && get_bit(model.mBitboards[p], e7)))
 				{
 					blackTotal -= 8;
 				}
@@ -1430,11 +825,11 @@ int Agent::Evaluate()
 				// stop giving checks in the early game on b4, g4
 				if (earlyGame)
 				{
-					if (square == b4 && get_bit(mModel.mOccupancies[white], c3))
+					if (square == b4 && get_bit(model.mOccupancies[white], c3))
 					{
 						blackTotal += 2;
 					}
-					if (square == g4 && get_bit(mModel.mOccupancies[white], f3))
+					if (square == g4 && get_bit(model.mOccupancies[white], f3))
 					{
 						blackTotal += 2;
 					}
@@ -1444,17 +839,15 @@ int Agent::Evaluate()
 				bishopXrayAttacks = mAttackTables.getBishopAttacks(square, 0);
 
 				// "biting on granite" penalty
-				blackTotal -= countBits(bishopXrayAttacks & mModel.mBitboards[P]);
+				blackTotal -= countBits(bishopXrayAttacks & model.mBitboards[P]);
 
-				attackBitboard = mAttackTables.getBishopAttacks(square, mModel.mOccupancies[both]);
+				attackBitboard = mAttackTables.getBishopAttacks(square, model.mOccupancies[both]);
 
 				blackControlledSquares += countBits(attackBitboard);
 			}
 			else if (i == r)
 			{
 				blackRooksCount++;
-				blackTotal += 500;
-				blackTotal += rookPlacementTable[square];
 
 				tropismToWhiteKing += mRookDistanceTable[square][whiteKingSquare];
 
@@ -1466,7 +859,7 @@ int Agent::Evaluate()
 				}
 
 				// controlling open files
-				if ((mModel.mBitboards[r] & fileConstants[file]) == (mModel.mOccupancies[both] & fileConstants[file]))
+				if ((model.mBitboards[r] & fileConstants[file]) == (model.mOccupancies[both] & fileConstants[file]))
 				{
 					blackTotal += 5;
 				}
@@ -1494,7 +887,7 @@ int Agent::Evaluate()
 					blackTotal += 10;
 
 					// connected rook
-					blackTotal += ConnectedRooksBonus(rook1, rook2);
+					blackTotal += ConnectedRooksBonus(model, rook1, rook2);
 
 					if (rookSecondRankCount == 2)
 					{
@@ -1502,14 +895,14 @@ int Agent::Evaluate()
 					}
 				}
 
-				attackBitboard = mAttackTables.getRookAttacks(square, mModel.mOccupancies[both]);
+				attackBitboard = mAttackTables.getRookAttacks(square, model.mOccupancies[both]);
 
 
 
 				// trapped rook
 				if (countBits(attackBitboard) <= 3)
 				{
-					if (square == a8 && get_bit(mModel.mOccupancies[both], a6) || square == h8 && get_bit(mModel.mOccupancies[both], h6))
+					if (square == a8 && get_bit(model.mOccupancies[both], a6) || square == h8 && get_bit(model.mOccupancies[both], h6))
 					{
 						blackTotal -= 105;
 					}
@@ -1524,8 +917,6 @@ int Agent::Evaluate()
 			else if (i == q)
 			{
 				blackQueensCount++;
-				blackTotal += 900;
-				blackTotal += queenPlacementTable[square];
 
 				tropismToWhiteKing += mQueenDistanceTable[square][whiteKingSquare];
 
@@ -1535,7 +926,7 @@ int Agent::Evaluate()
 					blackTotal -= 10;
 				}
 
-				attackBitboard = mAttackTables.getQueenAttacks(square, mModel.mOccupancies[both]);
+				attackBitboard = mAttackTables.getQueenAttacks(square, model.mOccupancies[both]);
 
 				blackControlledSquares += countBits(attackBitboard);
 			}
@@ -1586,8 +977,8 @@ int Agent::Evaluate()
 
 	// count the non pawn material for both sides
 	// scale it by a factor of 2
-	int whiteNonPawnMateial = (3 * whiteKnightsCount + 3 * whiteBishopsCount + 5 * whiteRooksCount + 9 * whiteQueensCount) * 2;
-	int blackNonPawnMaterial = (3 * blackKnightsCount + 3 * blackBishopsCount + 5 * blackRooksCount + 9 * blackQueensCount) * 2;
+	int whiteNonPawnMateial = model.mPhase[white] * 2;
+	int blackNonPawnMaterial = model.mPhase[black] * 2;
 	int lowestNonPawnMaterial = whiteNonPawnMateial < blackNonPawnMaterial ? whiteNonPawnMateial : blackNonPawnMaterial;
 
 	// drawn positions
@@ -1638,35 +1029,23 @@ int Agent::Evaluate()
 	whiteTotal += endgamePhaseConstant * whitePassedPawnBonus / 34;
 	blackTotal += endgamePhaseConstant * blackPassedPawnBonus / 34;
 
-	// apply king bonuses
-	//white king
-	int square = get_LS1B_index(mModel.mBitboards[K]);
-	whiteTotal += 10000;
-	// add the middle game and endgame values (tapered)
-	whiteTotal += (34 - endgamePhaseConstant) * kingPlacementTable[square] / 34;
-	whiteTotal += endgamePhaseConstant * kingEndgamePlacementTable[square] / 34;
-
-	// if the king is exposed, apply a penalty
-	whiteTotal -= (34 - endgamePhaseConstant) * countBits(mAttackTables.getQueenAttacks(square, mModel.mOccupancies[both])) / 34;
-
-
-	square = get_LS1B_index(mModel.mBitboards[k]);
-	blackTotal += 10000;
-	// add the middle game and endgame values (tapered)
-	blackTotal += (34 - endgamePhaseConstant) * kingPlacementTable[square] / 34;
-	blackTotal += endgamePhaseConstant * kingEndgamePlacementTable[square] / 34;
+	// material and placement kept by the model, the middle game and endgame values (tapered)
+	whiteTotal += ((34 - endgamePhaseConstant) * model.mMidgame[white] + endgamePhaseConstant * model.mEndgame[white]) / 34;
+	blackTotal += ((34 - endgamePhaseConstant) * model.mMidgame[black] + endgamePhaseConstant * model.mEndgame[black]) / 34;
 
+	// apply king bonuses
 	// if the king is exposed, apply a penalty
-	blackTotal -= (34 - endgamePhaseConstant) * countBits(mAttackTables.getQueenAttacks(square, mModel.mOccupancies[both])) / 34;
+	whiteTotal -= (34 - endgamePhaseConstant) * countBits(mAttackTables.getQueenAttacks(whiteKingSquare, model.mOccupancies[both])) / 34;
+	blackTotal -= (34 - endgamePhaseConstant) * countBits(mAttackTables.getQueenAttacks(blackKingSquare, model.mOccupancies[both])) / 34;
 
 	// king castle saftey
 	if (whiteCastledShort)
 	{
-		if (get_bit(mModel.mBitboards[P], g2))
+		if (get_bit(model.mBitboards[P], g2))
 		{
 			whiteTotal += 5;
 		}
-		else if (get_bit(mModel.mBitboards[P], g3))
+		else if (get_bit(model.mBitboards[P], g3))
 		{
 			whiteKingShield -= 1;
 			whiteTotal += 2;
@@ -1677,7 +1056,7 @@ int Agent::Evaluate()
 			whiteTotal -= 10;
 		}
 
-		if (get_bit(mModel.mBitboards[P], f2))
+		if (get_bit(model.mBitboards[P], f2))
 		{
 			whiteTotal += 6;
 		}
@@ -1687,7 +1066,7 @@ int Agent::Evaluate()
 			whiteTotal -= 10;
 		}
 
-		if ((blackQueensCount || blackRooksCount) && (mModel.mBitboards[P] & fileConstants[6]) == 0)
+		if ((blackQueensCount || blackRooksCount) && (model.mBitboards[P] & fileConstants[6]) == 0)
 		{
 			whiteKingShield -= 1;
 			whiteTotal -= 75;
@@ -1696,11 +1075,11 @@ int Agent::Evaluate()
 
 	if (whiteCastledLong)
 	{
-		if (get_bit(mModel.mBitboards[P], b2))
+		if (get_bit(model.mBitboards[P], b2))
 		{
 			whiteTotal += 5;
 		}
-		else if (get_bit(mModel.mBitboards[P], b3))
+		else if (get_bit(model.mBitboards[P], b3))
 		{
 			whiteKingShield -= 1;
 			whiteTotal += 2;
@@ -1711,7 +1090,7 @@ int Agent::Evaluate()
 			whiteTotal -= 10;
 		}
 
-		if (get_bit(mModel.mBitboards[P], c2))
+		if (get_bit(model.mBitboards[P], c2))
 		{
 			whiteTotal += 6;
 		}
@@ -1721,7 +1100,7 @@ int Agent::Evaluate()
 			whiteTotal -= 10;
 		}
 
-		if ((blackQueensCount || blackRooksCount) && (mModel.mBitboards[P] & fileConstants[1]) == 0)
+		if ((blackQueensCount || blackRooksCount) && (model.mBitboards[P] & fileConstants[1]) == 0)
 		{
 			whiteKingShield -= 1;
 			whiteTotal -= 75;
@@ -1730,11 +1109,11 @@ int Agent::Evaluate()
 
 	if (blackCastledShort)
 	{
-		if (get_bit(mModel.mBitboards[p], g7))
+		if (get_bit(model.mBitboards[p], g7))
 		{
 			blackTotal += 5;
 		}
-		else if (get_bit(mModel.mBitboards[p], g6))
+		else if (get_bit(model.mBitboards[p], g6))
 		{
 			blackKingShield -= 1;
 			blackTotal += 2;
@@ -1745,7 +1124,7 @@ int Agent::Evaluate()
 			blackTotal -= 10;
 		}
 
-		if (get_bit(mModel.mBitboards[p], f7))
+		if (get_bit(model.mBitboards[p], f7))
 		{
 			blackTotal += 6;
 		}
@@ -1755,7 +1134,7 @@ int Agent::Evaluate()
 			blackTotal -= 10;
 		}
 
-		if ((whiteQueensCount || whiteRooksCount) && (mModel.mBitboards[p] & fileConstants[6]) == 0)
+		if ((whiteQueensCount || whiteRooksCount) && (model.mBitboards[p] & fileConstants[6]) == 0)
 		{
 			blackKingShield -= 1;
 			blackTotal -= 75;
@@ -1764,11 +1143,11 @@ int Agent::Evaluate()
 
 	if (blackCastledLong)
 	{
-		if (get_bit(mModel.mBitboards[p], b7))
+		if (get_bit(model.mBitboards[p], b7))
 		{
 			blackTotal += 5;
 		}
-		else if (get_bit(mModel.mBitboards[p], b6))
+		else if (get_bit(model.mBitboards[p], b6))
 		{
 			blackKingShield -= 1;
 			blackTotal += 2;
@@ -1779,7 +1158,7 @@ int Agent::Evaluate()
 			blackTotal -= 10;
 		}
 
-		if (get_bit(mModel.mBitboards[p], c7))
+		if (get_bit(model.mBitboards[p], c7))
 		{
 			blackTotal += 6;
 		}
@@ -1789,7 +1168,7 @@ int Agent::Evaluate()
 			blackTotal -= 10;
 		}
 
-		if ((whiteQueensCount || whiteRooksCount) && (mModel.mBitboards[p] & fileConstants[1]) == 0)
+		if ((whiteQueensCount || whiteRooksCount) && (model.mBitboards[p] & fileConstants[1]) == 0)
 		{
 			blackKingShield -= 1;
 			blackTotal -= 75;
@@ -1798,14 +1177,14 @@ int Agent::Evaluate()
 
 	int notCastledPenalty = 0;
 	// really late castling pentalty
-	if (!whiteCastledLong && !whiteCastledShort && mModel.mFullMoves < 20)
+	if (!whiteCastledLong && !whiteCastledShort && model.mFullMoves < 20)
 	{
-		notCastledPenalty = ((34 - endgamePhaseConstant) * 5 * mModel.mFullMoves) / 34;
+		notCastledPenalty = ((34 - endgamePhaseConstant) * 5 * model.mFullMoves) / 34;
 		whiteTotal -= notCastledPenalty;
 	}
-	if (!blackCastledLong && !blackCastledShort && mModel.mFullMoves < 20)
+	if (!blackCastledLong && !blackCastledShort && model.mFullMoves < 20)
 	{
-		notCastledPenalty = ((34 - endgamePhaseConstant) * 5 * mModel.mFullMoves) / 34;
+		notCastledPenalty = ((34 - endgamePhaseConstant) * 5 * model.mFullMoves) / 34;
 		blackTotal -= notCastledPenalty;
 	}
 
@@ -1840,7 +1219,7 @@ int Agent::Evaluate()
 
 	// tempo, give a bonus for having the right to move
 
-	if (mModel.mSideToMove == white)
+	if (model.mSideToMove == white)
 	{
 		whiteTotal += 10;
 	}
@@ -1863,7 +1242,7 @@ int Agent::Evaluate()
 	int eval = whiteTotal - blackTotal;
 
 	// force the king to the side of the board in the endgame
-	if (mModel.GetSideToMove() == white)
+	if (model.GetSideToMove() == white)
 	{
 		eval += endgamePhaseConstant * ForceKingToCorner(whiteKingSquare, blackKingSquare) / 34;
 	}
@@ -1873,7 +1252,7 @@ int Agent::Evaluate()
 	}
 
 	// negamax implementation
-	if (mModel.mSideToMove == white)
+	if (model.mSideToMove == white)
 	{
 		return eval;
 	}
@@ -1911,7 +1290,7 @@ int Agent::ForceKingToCorner(int friendlyKingSquare, int opponentKingSquare)
 }
 
 
-int Agent::ConnectedRooksBonus(int square1, int square2)
+int Agent::ConnectedRooksBonus(Model& model, int square1, int square2)
 {
 	// check if rooks are on same rank
 	if (square1 / 8 == square2 / 8)
@@ -1931,7 +1310,7 @@ int Agent::ConnectedRooksBonus(int square1, int square2)
 		// now loop through the squares between them and see if there is nothing in the way
 		for (int i = leftRook + 1; i < rightRook - 1; i++)
 		{
-			if (get_bit(mModel.mOccupancies[both], i))
+			if (get_bit(model.mOccupancies[both], i))
 			{
 				return 0;
 			}
@@ -1958,7 +1337,7 @@ int Agent::ConnectedRooksBonus(int square1, int square2)
 
 		for (int i = bottomRook + 8; i < topRook - 8; i += 8)
 		{
-			if (get_bit(mModel.mOccupancies[both], i))
+			if (get_bit(model.mOccupancies[both], i))
 			{
 				return 0;
 			}
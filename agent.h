@@ -4,11 +4,13 @@
 #include "helper.h"
 #include "defs.h"
 #include "zobrist.h"
+#include "search_thread.h"
 
 #include <cstdlib>
 #include <ctime>
 #include <algorithm>
 #include <unordered_map>
+#include <mutex>
 
 const int CHECKMATESCORE = 10000;
 const int ALPHA = -10000000;
@@ -24,106 +26,6 @@ const int reductionLimit = 3;
 // non-pawn material count
 const int INITIAL_PIECE_MATERIAL = 2 * 3  +  2 * 3  +  2 * 5  +  1 * 9;
 
-const std::vector<int> kingPlacementTable = {
-	 2,  20,  19,  0,  0, -2,  20,  0,
-	-2, -2, -2, -3, -3, -3, -2, -2,
-	-4, -4, -4, -4, -4, -4, -4, -4,
-	-5, -5, -5, -5, -5, -5, -5, -5,
-	-5, -5, -5, -5, -5, -5, -5, -5,
-	-4, -4, -4, -4, -4, -4, -4, -4,
-	2, -2, -2, -3, -3, -3, -2, -2,
-	 2,  20,  19,  0,  0, -2,  20,  0,
-};
-
-const std::vector<int> kingEndgamePlacementTable = {
-   -2,-1, 0, 0, 0, 0,-1,-2,
-   -1, 4, 4, 4, 4, 4, 4,-1,
-	0, 4, 6, 6, 6, 6, 4, 0,
-	0, 4, 6, 9, 9, 6, 4, 0,
-	0, 4, 6, 9, 9, 6, 4, 0,
-	0, 4, 6, 6, 6, 6, 4, 0,
-   -1, 4, 4, 4, 4, 4, 4,-1,
-   -2,-1, 0, 0, 0, 0,-1,-2,
-};
-
-
-const std::vector<int> knightPlacementTable = {
-   -3,-1, 0, 0, 0, 0,-1,-3,
-	0, 2, 2, 3, 3, 2, 2, 0,
-   -1, 2, 4, 4, 4, 4, 2,-1,
-	0, 2, 4, 5, 5, 4, 2, 0,
-    0, 2, 4, 5, 5, 4, 2, 0,
-   -1, 2, 4, 4, 4, 4, 2,-1,
-	0, 2, 2, 3, 3, 2, 2, 0,
-   -3,-1, 0, 0, 0, 0,-1,-3,
-};
-
-const std::vector<int> bishopPlacementTable = {
-	3, 2,-1, 3, 3,-1, 2, 3,
-	3, 3, 4, 2, 2, 4, 3, 3,
-	1, 4, 5, 4, 4, 5, 4, 1,
-	1, 3, 4, 5, 5, 4, 3, 1,
-	1, 3, 4, 5, 5, 4, 3, 1,
-	1, 4, 5, 4, 4, 5, 4, 1,
-	3, 3, 4, 2, 2, 4, 3, 3,
-	3, 2,-1, 3, 3,-1, 2, 3,
-};
-
-const std::vector<int> rookPlacementTable = {
-	1, 1, 1, 6, 6, 2, 1, 1,
-	1, 5, 5, 5, 5, 5, 5, 1,
-	1, 3, 3, 4, 4, 3, 3, 1,
-	3, 3, 3, 4, 4, 3, 3, 3,
-	3, 3, 3, 4, 4, 3, 3, 3,
-	1, 3, 3, 4, 4, 3, 3, 1,
-	1, 5, 5, 5, 5, 5, 5, 1,
-	1, 1, 1, 6, 6, 2, 1, 1,
-};
-
-const std::vector<int> pawnWhitePlacementTable = {
-	 0,   0,   0,   0,   0,   0,   0,   0,
-	 1,   1,   1,  -6,  -6,   1,   1,   1,
-	 0,   0,   3,   3,   3,  -5,   0,   0,
-	 0,   0,   3,   7,   7,  -5,  -5,   0,
-	 4,   4,   4,   8,   8,   4,   4,   4,
-	15,  15,  15,  15,  15,  15,  15,  15,
-   100, 100, 100, 100, 100, 100, 100, 100,
-	 0,   0,   0,   0,   0,   0,   0,   0,
-};
-
-const std::vector<int> pawnBlackPlacementTable = {
-	0,   0,   0,   0,   0,   0,   0,   0,
-  100, 100, 100, 100, 100, 100, 100, 100,
-   15,  15,  15,  15,  15,  15,  15,  15,
-	4,   4,   4,   8,   8,   4,   4,   4,
-	0,   0,   3,   7,   7,  -5,  -5,   0,
-	0,   0,   3,   3,   3,  -5,   0,   0,
-	1,   1,   1,  -6,  -6,   1,   1,   1,
-	0,   0,   0,   0,   0,   0,   0,   0,
-};
-
-const std::vector<int> queenPlacementTable = {
-	0, 0, 0, 0, 0, 0, 0, 0,
-	0, 1, 1, 2, 2, 1, 1, 0,
-	0, 2, 1, 1, 1, 2, 1, 0,
-	0, 1, 1, 3, 3, 1, 1, 0,
-	0, 1, 1, 3, 3, 1, 1, 0,
-	0, 2, 1, 1, 1, 2, 1, 0,
-	0, 1, 1, 2, 2, 1, 1, 0,
-	0, 0, 0, 0, 0, 0, 0, 0,
-};
-
-const std::vector<int> closenessToCenterFileBonus = {
-	1, 2, 3, 4, 4, 3, 2, 1,
-	1, 2, 3, 4, 4, 3, 2, 1,
-	1, 2, 3, 4, 4, 3, 2, 1,
-	1, 2, 3, 4, 4, 3, 2, 1,
-	1, 2, 3, 4, 4, 3, 2, 1,
-	1, 2, 3, 4, 4, 3, 2, 1,
-	1, 2, 3, 4, 4, 3, 2, 1,
-	1, 2, 3, 4, 4, 3, 2, 1,
-};
-
 const std::vector<int> blackPawnStormBonus = {
 	0, 0, 0, 0, 0, 0, 0, 0,
 	8, 8, 8, 8, 8, 8, 8, 8,
@@ -252,7 +154,7 @@ struct Node
 
 struct MoveScore
 {
-	unsigned long long move;
+	Move move;
 	int score;
 };
 
@@ -268,39 +170,55 @@ struct MoveScore
 struct TT_Entry
 {
 	unsigned long long hash_key;
-	int depth;
-	int flags;
 	int value;
+
+	// best move found at the position, zero when none was
+	PackedMove move;
+
+	unsigned char depth;
+	unsigned char flags;
 };
 
+// the table is shared between search threads without locks, so the key is stored
+// XOR'd with the entry data and a torn write no longer matches on probe,
+// the fields of an entry fill the 64 bits between them
+inline unsigned long long HashEntryData(int depth, int flags, int value, PackedMove move)
+{
+	return (unsigned long long)(unsigned int)value |
+		((unsigned long long)move << 32) |
+		((unsigned long long)(depth & 0xff) << 48) |
+		((unsigned long long)(flags & 0xff) << 56);
+}
+
 class Agent
 {
+	friend class SearchThread;
+
 public:
 	Agent(Zobrist *zTables);
+	~Agent();
 	void UpdateFromPercepts(Percepts state);
-	unsigned long long RandomAgentFunction();
+	Move RandomAgentFunction();
 
-	int Evaluate();
+	int Evaluate(Model& model);
 	int ForceKingToCorner(int friendlyKingSquare, int opponentKingSquare);
-	int ConnectedRooksBonus(int square1, int square2);
-
-
-	void PrintMoveScores(std::vector<unsigned long long> const & moves, Node* state);
-	int scoreMove(int move, int depth);
-	void OrderMoves(std::vector<unsigned long long>& moves, int depth);
-
-	void ResetKilleHistoryMoves();
-	void ResetPVMoves();
+	int ConnectedRooksBonus(Model& model, int square1, int square2);
 
 	void ClearTranspositionTable();
-	int ProbeHash(int alpha, int beta, int depth);
-	void RecordHash(int score, int depth, int hashFlag);
 
-	void EnablePvScoring(std::vector<unsigned long long> const& moves, int ply);
+	SearchResult SearchNegamax(SearchLimits const& limits);
+	SearchResult RunSearch(SearchThread* thread, std::vector<SearchThread*> const& helpers, SearchLimits const& limits, bool uci);
+	void StopSearch();
+	void PonderHit();
+	void ClearStop();
 
-	unsigned long long SearchNegamax(int depth);
-	int Negamax(int alpha, int beta, int depth);
-	int QuiescenceNegamax(int alpha, int beta, int depth);
+	// search thread pool
+	SearchThread* AcquireSearchThread();
+	void ReleaseSearchThread(SearchThread* thread);
+	void SetThreads(int threads);
+	void SetSmpMode(int mode);
+	void SetTimePolicy(TimePolicy const& policy);
+	void SetMultiPv(int lines);
 
 	void InitializeKingBonusPassedPawnTable();
 	void InitializeDistanceTables();
@@ -312,25 +230,31 @@ private:
 	Zobrist *mZobristTables;
 	
 	int mMaxDepth;
-	unsigned long long mNodes;
-	unsigned long long mPrincipalVariationMove;
+	Move mPrincipalVariationMove;
 	unsigned long long mTTSize;
-	unsigned long long mBestMoveNegamax;
-	int mMaxPvLength;
-	bool mFollowPvLine;
-	bool mScorePV;
+	Move mBestMoveNegamax;
 	int mOriginalSideToMove;
-	int mPly;
-	int mCurrentDepthStart;
-
-	std::vector<std::vector<unsigned long long>> mKillerMoves;
-	std::vector<std::vector<int>> mHistoryTable;
 
 	std::unordered_map<unsigned long long, int> mMoveHashesHistory;
 	std::vector<TT_Entry> mTranspositionTable;
 
-	std::vector<unsigned long long> mPvLength;
-	std::vector < std::vector<unsigned long long>> mPvTable;
+	// every search thread probes and stores here
+	TT_Entry* mHashTable;
+
+	// threads used by SearchNegamax, the first one owns the search and the rest help it
+	int mThreadCount;
+	int mSmpMode;
+	TimePolicy mTimePolicy;
+	int mMultiPv;
+
+	// raised from the UCI thread to end SearchNegamax early, or to start the clock on a ponder search
+	std::atomic<bool> mStopSearch;
+	std::atomic<bool> mPonderHit;
+
+	// every thread we have made and the ones nobody is searching with
+	std::mutex mPoolLock;
+	std::vector<SearchThread*> mSearchThreads;
+	std::vector<SearchThread*> mIdleSearchThreads;
 
 	// [color][passed pawn square][king square]
 	std::vector<std::vector<std::vector<int>>> mKingBonusPassedPawn;
@@ -236,15 +236,15 @@ unsigned long long AttackTables::calculatePawnAttackBitboard(int square, int sid
 {
 	// given a square and white/black calculate pawn attack bitboard
 	unsigned long long pawnAttackBitboard = 0;
-	if (side == white)
+	const int pawnOffsets[2][2] = { { 7, 9 }, { -7, -9 } };
+	for (int i = 0; i < 2; i++)
 	{
-		set_bit(pawnAttackBitboard, ((unsigned long long)square + 7));
-		set_bit(pawnAttackBitboard, ((unsigned long long)square + 9));
-	}
-	else
-	{
-		set_bit(pawnAttackBitboard, (unsigned long long)square - 7);
-		set_bit(pawnAttackBitboard, (unsigned long long)square - 9);
+		// a shift past either end of the board would wrap around to the other side
+		int target = square + pawnOffsets[side][i];
+		if (target >= 0 && target < 64)
+		{
+			set_bit(pawnAttackBitboard, target);
+		}
 	}
 
 	// if square is an h pawn, we need to exclude the a-file
@@ -266,14 +266,16 @@ unsigned long long AttackTables::calculateKnightAttackBitboard(int square)
 {
 	// given a square  calculate knight attack bitboard
 	unsigned long long knightAttackBitboard = 0;
-	set_bit(knightAttackBitboard, (unsigned long long)square + 6);
-	set_bit(knightAttackBitboard, (unsigned long long)square + 15);
-	set_bit(knightAttackBitboard, (unsigned long long)square + 17);
-	set_bit(knightAttackBitboard, (unsigned long long)square + 10);
-	set_bit(knightAttackBitboard, (unsigned long long)square - 6);
-	set_bit(knightAttackBitboard, (unsigned long long)square - 17);
-	set_bit(knightAttackBitboard, (unsigned long long)square - 15);
-	set_bit(knightAttackBitboard, (unsigned long long)square - 10);
+	const int knightOffsets[8] = { 6, 15, 17, 10, -6, -17, -15, -10 };
+	for (int i = 0; i < 8; i++)
+	{
+		// a shift past either end of the board would wrap around to the other side
+		int target = square + knightOffsets[i];
+		if (target >= 0 && target < 64)
+		{
+			set_bit(knightAttackBitboard, target);
+		}
+	}
 
 	// if square is g-file or h-file, don't include a-file and b-file
 	if (square % 8 == 6 || square % 8 == 7)
@@ -294,14 +296,16 @@ unsigned long long AttackTables::calculateKingAttackBitboard(int square)
 {
 	// given a square, calculate king attack bitboard
 	unsigned long long kingAttackBitboard = 0;
-	set_bit(kingAttackBitboard, (unsigned long long)square + 7);
-	set_bit(kingAttackBitboard, (unsigned long long)square + 8);
-	set_bit(kingAttackBitboard, (unsigned long long)square + 9);
-	set_bit(kingAttackBitboard, (unsigned long long)square - 1);
-	set_bit(kingAttackBitboard, (unsigned long long)square + 1);
-	set_bit(kingAttackBitboard, (unsigned long long)square - 9);
-	set_bit(kingAttackBitboard, (unsigned long long)square - 8);
-	set_bit(kingAttackBitboard, (unsigned long long)square - 7);
+	const int kingOffsets[8] = { 7, 8, 9, -1, 1, -9, -8, -7 };
+	for (int i = 0; i < 8; i++)
+	{
+		// a shift past either end of the board would wrap around to the other side
+		int target = square + kingOffsets[i];
+		if (target >= 0 && target < 64)
+		{
+			set_bit(kingAttackBitboard, target);
+		}
+	}
 
 	// if square is on h-file, do not include a-file
 	if (square % 8 == 7)
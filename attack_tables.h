@@ -309,6 +309,36 @@ public:
 		return false;
 	}
 
+	// pieces of both sides attacking the square, sliders look through the occupancy given so that
+	// taking pieces out of it uncovers the x-ray attackers behind them
+	inline unsigned long long AttackersTo(int square, unsigned long long occupancy, std::vector<unsigned long long> const& bitboards)
+	{
+		return (mPawnAttacks[black][square] & bitboards[P]) |
+			(mPawnAttacks[white][square] & bitboards[p]) |
+			(mKnightAttacks[square] & (bitboards[N] | bitboards[n])) |
+			(mKingAttacks[square] & (bitboards[K] | bitboards[k])) |
+			(getBishopAttacks(square, occupancy) & (bitboards[B] | bitboards[b] | bitboards[Q] | bitboards[q])) |
+			(getRookAttacks(square, occupancy) & (bitboards[R] | bitboards[r] | bitboards[Q] | bitboards[q]));
+	}
+
+	// squares strictly between two squares on the same rank, file or diagonal, empty when they don't share a line
+	inline unsigned long long Between(int square1, int square2)
+	{
+		unsigned long long bitboard1 = (unsigned long long)1 << square1;
+		unsigned long long bitboard2 = (unsigned long long)1 << square2;
+
+		// each ray stops at the other square, so the two only meet on the squares in between
+		if (getRookAttacks(square1, 0) & bitboard2)
+		{
+			return getRookAttacks(square1, bitboard2) & getRookAttacks(square2, bitboard1);
+		}
+		if (getBishopAttacks(square1, 0) & bitboard2)
+		{
+			return getBishopAttacks(square1, bitboard2) & getBishopAttacks(square2, bitboard1);
+		}
+		return 0;
+	}
+
 	unsigned long long findMagicNumber(int square, int relavantBits, int bishop);
 	void initializeMagicNumbers();
 
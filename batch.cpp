@@ -0,0 +1,194 @@
+#include "batch.h"
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <chrono>
+
+bool ParseBatchLine(std::string line, BatchPosition& position)
+{
+	// split into fields
+	std::istringstream stream(line);
+	std::vector<std::string> fields;
+	std::string field;
+	while (stream >> field)
+	{
+		fields.push_back(field);
+	}
+
+	// skip blank lines, comments and anything too short to be a position
+	if (fields.size() < 4 || fields[0][0] == '#')
+	{
+		return false;
+	}
+
+	position.fen = fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3];
+
+	// a FEN carries the move clocks, EPD has operations in their place
+	if (fields.size() >= 6 &&
+		fields[4].find_first_not_of("0123456789") == std::string::npos &&
+		fields[5].find_first_not_of("0123456789") == std::string::npos)
+	{
+		position.fen += " " + fields[4] + " " + fields[5];
+	}
+	else
+	{
+		position.fen += " 0 1";
+	}
+
+	// keep the EPD id so results can be matched up
+	position.id = "";
+	size_t id = line.find("id \"");
+	if (id != std::string::npos)
+	{
+		size_t end = line.find('"', id + 4);
+		if (end != std::string::npos)
+		{
+			position.id = line.substr(id + 4, end - id - 4);
+		}
+	}
+
+	return true;
+}
+
+void BatchWorker(Agent* agent, BatchJob* job)
+{
+	// each worker searches with its own model, killers, history and PV
+	SearchThread* thread = agent->AcquireSearchThread();
+
+	while (true)
+	{
+		int index = job->nextPosition++;
+		if (index >= job->positions.size())
+		{
+			break;
+		}
+
+		unsigned long long time_start = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+		thread->LoadPosition(job->positions[index].fen);
+		SearchResult result = agent->RunSearch(thread, {}, job->limits, false);
+
+		unsigned long long time_end = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+		// build the whole output first so that workers don't interleave their lines, one line per MultiPV line
+		std::ostringstream output;
+		for (int line = 0; line < result.lines.size(); line++)
+		{
+			SearchLine const& searchLine = result.lines[line];
+			output << "position " << index + 1;
+			if (job->positions[index].id != "")
+			{
+				output << " id \"" << job->positions[index].id << "\"";
+			}
+			if (job->multiPv > 1)
+			{
+				output << " multipv " << line + 1;
+			}
+			output << " bestmove " << moveToString(searchLine.pv.size() ? searchLine.pv[0] : 0) << " score " << searchLine.score << " depth " << result.depth;
+			output << " nodes " << result.nodes << " time " << time_end - time_start << " pv";
+			for (int i = 0; i < searchLine.pv.size(); i++)
+			{
+				output << " " << moveToString(searchLine.pv[i]);
+			}
+			output << "\n";
+		}
+
+		std::lock_guard<std::mutex> guard(job->outputLock);
+		std::cout << output.str() << std::flush;
+	}
+
+	agent->ReleaseSearchThread(thread);
+}
+
+void BatchAnalysis(Agent* agent, std::istream& input, SearchLimits limits, int workers, int multiPv)
+{
+	BatchJob job;
+	job.nextPosition = 0;
+	job.limits = limits;
+	job.multiPv = multiPv;
+
+	// read every position up front
+	std::string line;
+	while (std::getline(input, line))
+	{
+		BatchPosition position;
+		if (ParseBatchLine(line, position))
+		{
+			job.positions.push_back(position);
+		}
+	}
+
+	// all workers share the agent's transposition table, start it empty
+	agent->ClearTranspositionTable();
+	agent->SetMultiPv(multiPv);
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < workers; i++)
+	{
+		threads.push_back(std::thread(BatchWorker, agent, &job));
+	}
+	for (int i = 0; i < threads.size(); i++)
+	{
+		threads[i].join();
+	}
+}
+
+int BatchMain(Agent* agent, int argc, char* argv[])
+{
+	SearchLimits limits = {};
+	int workers = std::max(1, (int)std::thread::hardware_concurrency());
+	int multiPv = 1;
+	std::string file = "-";
+
+	// parse the arguments
+	for (int i = 0; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "depth" && i + 1 < argc)
+		{
+			limits.depth = atoi(argv[++i]);
+		}
+		else if (argument == "nodes" && i + 1 < argc)
+		{
+			limits.nodes = strtoull(argv[++i], NULL, 10);
+		}
+		else if (argument == "movetime" && i + 1 < argc)
+		{
+			limits.movetime = strtoull(argv[++i], NULL, 10);
+		}
+		else if (argument == "threads" && i + 1 < argc)
+		{
+			workers = std::max(1, std::min(atoi(argv[++i]), MAX_THREADS));
+		}
+		else if (argument == "multipv" && i + 1 < argc)
+		{
+			multiPv = std::max(1, std::min(atoi(argv[++i]), MAX_MULTI_PV));
+		}
+		else
+		{
+			file = argument;
+		}
+	}
+
+	// same default as "go" without a depth
+	if (!limits.depth && !limits.nodes && !limits.movetime)
+	{
+		limits.depth = 7;
+	}
+
+	if (file == "-")
+	{
+		BatchAnalysis(agent, std::cin, limits, workers, multiPv);
+		return 0;
+	}
+
+	std::ifstream input(file);
+	if (!input)
+	{
+		std::cout << "could not open " << file << std::endl;
+		return 1;
+	}
+	BatchAnalysis(agent, input, limits, workers, multiPv);
+	return 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "agent.h"
+#include "search_thread.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+// one FEN or EPD line of the input
+struct BatchPosition
+{
+	std::string fen;
+	std::string id;
+};
+
+// work shared by the batch workers
+struct BatchJob
+{
+	std::vector<BatchPosition> positions;
+	std::atomic<int> nextPosition;
+	SearchLimits limits;
+	int multiPv;
+	std::mutex outputLock;
+};
+
+bool ParseBatchLine(std::string line, BatchPosition& position);
+
+void BatchWorker(Agent* agent, BatchJob* job);
+
+void BatchAnalysis(Agent* agent, std::istream& input, SearchLimits limits, int workers, int multiPv);
+
+// "batch [file] [depth N] [nodes N] [movetime N] [threads N] [multipv N]" from the command line
+int BatchMain(Agent* agent, int argc, char* argv[]);
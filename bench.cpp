@@ -0,0 +1,68 @@
+#include "bench.h"
+
+#include <chrono>
+
+// openings, middlegames and endgames, searched in order on one thread with a fresh transposition table
+// each, so that the node count only changes when the search does
+const std::vector<std::string> benchPositions = {
+	"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+	"r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+	"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+	"rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+	"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+	"2rq1rk1/pp1bppbp/2np1np1/8/3NP3/1BN1BP2/PPPQ2PP/2KR3R b - - 0 11",
+	"r1bq1rk1/ppp2ppp/2np1n2/2b1p3/2B1P3/2PP1N2/PP3PPP/RNBQ1RK1 w - - 1 7",
+	"6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+	"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+	"8/8/4k3/3p4/3P4/4K3/8/8 w - - 0 1",
+};
+
+int BenchMain(Agent* agent, int argc, char* argv[])
+{
+	SearchLimits limits = {};
+	limits.depth = 7;
+
+	// parse the arguments
+	for (int i = 0; i + 1 < argc; i += 2)
+	{
+		std::string argument = argv[i];
+		if (argument == "depth")
+		{
+			limits.depth = atoi(argv[i + 1]);
+		}
+	}
+
+	SearchThread* thread = agent->AcquireSearchThread();
+	unsigned long long totalNodes = 0;
+	unsigned long long totalTime = 0;
+	unsigned long long totalCutoffs = 0;
+	unsigned long long totalFirstMoveCutoffs = 0;
+	int totalFailHighs = 0;
+	int totalFailLows = 0;
+
+	for (int i = 0; i < benchPositions.size(); i++)
+	{
+		agent->ClearTranspositionTable();
+		thread->LoadPosition(benchPositions[i]);
+
+		unsigned long long time_start = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		SearchResult result = agent->RunSearch(thread, {}, limits, false);
+		unsigned long long time_end = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+		totalNodes += result.nodes;
+		totalTime += time_end - time_start;
+		totalCutoffs += result.cutoffs;
+		totalFirstMoveCutoffs += result.firstMoveCutoffs;
+		totalFailHighs += result.failHighs;
+		totalFailLows += result.failLows;
+		std::cout << "position " << i + 1 << " bestmove " << moveToString(result.bestMove) << " score " << result.score <<
+			" nodes " << result.nodes << " time " << time_end - time_start << std::endl;
+	}
+	agent->ReleaseSearchThread(thread);
+
+	std::cout << "bench depth " << limits.depth << " nodes " << totalNodes << " time " << totalTime <<
+		" nps " << totalNodes * 1000 / std::max(1ULL, totalTime) <<
+		" first move cutoffs " << totalFirstMoveCutoffs * 1000 / std::max(1ULL, totalCutoffs) / 10.0 << "%" <<
+		" aspiration researches " << totalFailHighs + totalFailLows << " fail high " << totalFailHighs << " fail low " << totalFailLows << std::endl;
+	return 0;
+}
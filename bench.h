@@ -0,0 +1,9 @@
+#pragma once
+#include "agent.h"
+#include "search_thread.h"
+
+#include <string>
+#include <vector>
+
+// "bench [depth N]" from the command line, total nodes and speed over the bench positions
+int BenchMain(Agent* agent, int argc, char* argv[]);
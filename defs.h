@@ -17,6 +17,19 @@ struct Percepts
 	std::map<unsigned long long, int> movesHistory;
 };
 
+// limits from the UCI "go" command, zero means not given
+struct SearchLimits
+{
+	int depth;
+	unsigned long long nodes;
+	unsigned long long movetime;
+	unsigned long long time[2];
+	unsigned long long increment[2];
+	int movestogo;
+	bool infinite;
+	bool ponder;
+};
+
 //bit macros
 #define get_bit(bitboard, square) ((bitboard) & ((unsigned long long)1 << (square)))
 #define set_bit(bitboard, square) ((bitboard) |= ((unsigned long long)1 << (square)))
@@ -98,40 +111,51 @@ const std::vector<int> castlingRightsConstants = {
 
 */
 
+// a move in a move list, the full 24 bit encoding above
+typedef unsigned int Move;
+
+// a move as the transposition table keeps it, start and destination squares and the promoted piece
+typedef unsigned short PackedMove;
+
 // encoding a move
-#define encode_move(starting, destination, piece, promoted, capture, double_push, enpassant, castling) \
-	(starting) |				\
-	((destination) << 6) |		\
-	((piece) << 12) |			\
-	((promoted) << 16) |		\
-	((capture) << 20) |			\
-	((double_push) << 21) |		\
-	((enpassant) << 22) |		\
-	((castling) << 23)
+inline Move encode_move(int starting, int destination, int piece, int promoted, int capture, int double_push, int enpassant, int castling)
+{
+	return starting |
+		(destination << 6) |
+		(piece << 12) |
+		(promoted << 16) |
+		(capture << 20) |
+		(double_push << 21) |
+		(enpassant << 22) |
+		(castling << 23);
+}
 
 // extracting the starting square
-#define decode_start_square(move) ((move) & 0x3f)
+inline int decode_start_square(Move move) { return move & 0x3f; }
 
 // extracting the destination square
-#define decode_destination_square(move) (((move) & 0xfc0) >> 6)
+inline int decode_destination_square(Move move) { return (move & 0xfc0) >> 6; }
 
 // extracting the piece type
-#define decode_piece_type(move) (((move) & 0xf000) >> 12)
+inline int decode_piece_type(Move move) { return (move & 0xf000) >> 12; }
 
 // extracting the promoted piece type
-#define decode_promoted_piece_type(move) (((move) & 0xf0000) >> 16)
+inline int decode_promoted_piece_type(Move move) { return (move & 0xf0000) >> 16; }
 
 // extracting the capture flag
-#define decode_capture_flag(move) (((move) & 0x100000))
+inline bool decode_capture_flag(Move move) { return move & 0x100000; }
 
 // extracting the double pawn push flag
-#define decode_double_push_flag(move) (((move) & 0x200000))
+inline bool decode_double_push_flag(Move move) { return move & 0x200000; }
 
 // extracting the enpassant flag
-#define decode_enpassant_flag(move) (((move) & 0x400000))
+inline bool decode_enpassant_flag(Move move) { return move & 0x400000; }
 
 // extracting the castling flag
-#define decode_castling_flag(move) (((move) & 0x800000))
+inline bool decode_castling_flag(Move move) { return move & 0x800000; }
+
+// packing a move for the transposition table, the squares and promoted piece are enough to find it in a move list
+inline PackedMove pack_move(Move move) { return (PackedMove)((move & 0xfff) | ((move & 0xf0000) >> 4)); }
 
 //enum board squres
 
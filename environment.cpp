@@ -60,10 +60,10 @@ Percepts Environment::GetPercepts()
 	return state;
 }
 
-unsigned long long Environment::ParseMove(const char* moveString)
+Move Environment::ParseMove(const char* moveString)
 {
 	// generate moves
-	std::vector<unsigned long long> moves;
+	std::vector<Move> moves;
 	mModel.generateMoves(moves);
 
 	// get the source square
@@ -76,7 +76,7 @@ unsigned long long Environment::ParseMove(const char* moveString)
 
 	for (int i = 0; i < moves.size(); i++)
 	{
-		unsigned long long move = moves[i];
+		Move move = moves[i];
 
 		// make sure the source and destination squares are in the generated moves
 		if (sourceSquare == decode_start_square(moves[i]) && destinationSquare == decode_destination_square(moves[i]))
@@ -119,7 +119,7 @@ unsigned long long Environment::ParseMove(const char* moveString)
 	return 0;
 }
 
-void Environment::MakeMove(unsigned long long move)
+void Environment::MakeMove(Move move)
 {
 	mMovesMade.push_back(move);
 	mModel.MakeMove(move, allMoves);
@@ -191,7 +191,7 @@ void Environment::ParsePosition(const char* command)
 		while (*currentChar)
 		{
 			// parse next move
-			unsigned long long move = ParseMove(currentChar);
+			Move move = ParseMove(currentChar);
 
 			// if no more moves
 			if (move == 0)
@@ -215,27 +215,72 @@ void Environment::ParsePosition(const char* command)
 	}
 }
 
-int Environment::ParseGoDepth(const char* command)
+SearchLimits Environment::ParseGo(const char* command)
 {
-	// initialize depth
-	int depth = -1;
+	SearchLimits limits = {};
 
-	// init char pointer to depth argument
-	const char* currentDepth = NULL;
+	// init char pointer to the current argument
+	const char* argument = NULL;
 
 	// handle fixed depth search
-	if (currentDepth = strstr(command, "depth"))
+	if (argument = strstr(command, "depth"))
 	{
 		// convert str to integer and assign to depth
-		depth = atoi(currentDepth + 6);
+		limits.depth = atoi(argument + 6);
 	}
-	else
+
+	// fixed node count and fixed time searches
+	if (argument = strstr(command, "nodes"))
+	{
+		limits.nodes = strtoull(argument + 6, NULL, 10);
+	}
+	if (argument = strstr(command, "movetime"))
+	{
+		limits.movetime = strtoull(argument + 9, NULL, 10);
+	}
+
+	// clock times and increments in ms
+	if (argument = strstr(command, "wtime"))
+	{
+		limits.time[white] = strtoull(argument + 6, NULL, 10);
+	}
+	if (argument = strstr(command, "btime"))
+	{
+		limits.time[black] = strtoull(argument + 6, NULL, 10);
+	}
+	if (argument = strstr(command, "winc"))
+	{
+		limits.increment[white] = strtoull(argument + 5, NULL, 10);
+	}
+	if (argument = strstr(command, "binc"))
+	{
+		limits.increment[black] = strtoull(argument + 5, NULL, 10);
+	}
+	if (argument = strstr(command, "movestogo"))
+	{
+		limits.movestogo = atoi(argument + 10);
+	}
+
+	// search until "stop"
+	if (strstr(command, "infinite"))
+	{
+		limits.infinite = true;
+	}
+
+	// think on the opponent's time until "ponderhit" starts our clock
+	if (strstr(command, "ponder"))
+	{
+		limits.ponder = true;
+	}
+
+	// plain "go", search to the old default depth
+	if (!limits.depth && !limits.nodes && !limits.movetime && !limits.time[white] && !limits.time[black] &&
+		!limits.infinite && !limits.ponder)
 	{
-		depth = 7;
+		limits.depth = 7;
 	}
 
-	std::cout << "depth: " << depth << std::endl;
-	return depth;
+	return limits;
 }
 
 bool Environment::Done()
@@ -288,7 +333,7 @@ void Environment::PrintMadeMoves()
 
 void Environment::ListCurrentPositionMoves()
 {
-	std::vector<unsigned long long> moves;
+	std::vector<Move> moves;
 	mModel.generateMoves(moves);
 
 	for (int i = 0; i < moves.size(); i++)
@@ -302,7 +347,7 @@ void Environment::ListCurrentPositionMoves()
 void Environment::UndoMove()
 {
 	// get the last move played
-	unsigned long long lastMovePlayed = mMovesMade[mMovesMade.size() - 1];
+	Move lastMovePlayed = mMovesMade[mMovesMade.size() - 1];
 	unsigned long long hash = mModel.GetHash();
 	mModel.UnmakeMove(lastMovePlayed);
 	mMovesMade.pop_back();
@@ -20,10 +20,10 @@ public:
 	void PrintOccupancy(int side);
 	void LoadPosition(std::string FEN);
 	Percepts GetPercepts();
-	unsigned long long ParseMove(const char* moveString);
-	void MakeMove(unsigned long long move);
+	Move ParseMove(const char* moveString);
+	void MakeMove(Move move);
 	void ParsePosition(const char* command);
-	int ParseGoDepth(const char* command);
+	SearchLimits ParseGo(const char* command);
 	bool Done();
 	void PrintMadeMoves();
 	void ListCurrentPositionMoves();
@@ -33,7 +33,7 @@ public:
 	AttackTables mAttackTables;
 	Zobrist *mZobristTables;
 	
-	std::vector<unsigned long long> mMovesMade;
+	std::vector<Move> mMovesMade;
 	std::vector<unsigned long long> mHashRepititionList;
 	std::unordered_map<unsigned long long, int> mMoveHashesHistory;
 	std::vector< std::vector<unsigned long long> > mZorbristRandomNumbers;
@@ -64,7 +64,7 @@ unsigned long long generateMagicNumber()
 	return getRandom64BitNumber() & getRandom64BitNumber() & getRandom64BitNumber();
 }
 
-void printMoveInformation(unsigned long long move)
+void printMoveInformation(Move move)
 {
 	int piece_type = decode_piece_type(move);
 
@@ -80,41 +80,60 @@ void printMoveInformation(unsigned long long move)
 	std::cout << "\nenpassant flag: " << enpassant_flag << "\ncastling flag: " << castling_flag << std::endl << std::endl;;
 }
 
-void printMove(unsigned long long move)
+void printMove(Move move)
+{
+	std::cout << moveToString(move);
+}
+
+std::string moveToString(Move move)
 {
 	int start_square = decode_start_square(move);
 	int destination_square = decode_destination_square(move);
-	int piece_type = decode_piece_type(move);
 	int promotedPieceType = decode_promoted_piece_type(move);
 
-	std::cout << square_to_coordinates[start_square];
-	std::cout << square_to_coordinates[destination_square];
+	std::string moveString = square_to_coordinates[start_square];
+	moveString += square_to_coordinates[destination_square];
 
-	// print the promoted piece if available
+	// add the promoted piece if available
 	// promoted piece flag is active
 	if (promotedPieceType)
 	{
 		if (promotedPieceType == Q || promotedPieceType == q)
 		{
-			// print piece
-			std::cout << "q";
+			// add piece
+			moveString += "q";
 		}
 		else if (promotedPieceType == R || promotedPieceType == r)
 		{
-			std::cout << "r";
+			moveString += "r";
 		}
 		else if (promotedPieceType == B || promotedPieceType == b)
 		{
-			std::cout << "b";
+			moveString += "b";
 		}
 		else if (promotedPieceType == N || promotedPieceType == n)
 		{
-			std::cout << "n";
+			moveString += "n";
 		}
 	}
+	return moveString;
+}
+
+std::string scoreToString(int score)
+{
+	// mate scores are 49000 less the ply of the mate
+	if (score > 45000)
+	{
+		return "mate " + std::to_string((49000 - score + 1) / 2);
+	}
+	if (score < -45000)
+	{
+		return "mate " + std::to_string(-(49000 + score) / 2);
+	}
+	return "cp " + std::to_string(score);
 }
 
-void printMoveList(std::vector<unsigned long long> const& moves)
+void printMoveList(std::vector<Move> const& moves)
 {
 	for (int i = 0; i < moves.size(); i++)
 	{
@@ -69,9 +69,14 @@ unsigned long long getRandom64BitNumber();
 unsigned long long generateMagicNumber();
 
 
-void printMoveInformation(unsigned long long move);
+void printMoveInformation(Move move);
 
-void printMove(unsigned long long move);
+void printMove(Move move);
 
-void printMoveList(std::vector<unsigned long long> const& moves);
+std::string moveToString(Move move);
+
+// UCI score, "cp <centipawns>" or "mate <moves>" with a negative count when getting mated
+std::string scoreToString(int score);
+
+void printMoveList(std::vector<Move> const& moves);
 
@@ -6,12 +6,15 @@
 #include "perft.h"
 #include "zobrist.h"
 #include "uci.h"
+#include "batch.h"
+#include "selfplay.h"
+#include "bench.h"
 
 #include <iostream>
 #include <windows.h>
 #include <tchar.h>
 
-int main()
+int main(int argc, char* argv[])
 {
 
     // set the rng
@@ -21,6 +24,24 @@ int main()
     Environment env(&zobristTables);
     Agent agent(&zobristTables);
 
+    // analyse a list of positions instead of talking UCI
+    if (argc > 1 && strcmp(argv[1], "batch") == 0)
+    {
+        return BatchMain(&agent, argc - 2, argv + 2);
+    }
+
+    // fixed depth node count and speed
+    if (argc > 1 && strcmp(argv[1], "bench") == 0)
+    {
+        return BenchMain(&agent, argc - 2, argv + 2);
+    }
+
+    // adaptive against fixed time allocation
+    if (argc > 1 && strcmp(argv[1], "selfplay") == 0)
+    {
+        return SelfPlayMain(&zobristTables, argc - 2, argv + 2);
+    }
+
     env.PrintBoard();
     std::cout << std::endl;
 
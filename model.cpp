@@ -1,5 +1,46 @@
 #include "model.h"
 
+const PieceSquareTables pieceSquareTables;
+
+PieceSquareTables::PieceSquareTables()
+{
+	// the evaluation's piece values, the king is never off the board
+	const int pieceValues[6] = { 100, 320, 330, 500, 900, 0 };
+	const int piecePhases[6] = { 0, 3, 3, 5, 9, 0 };
+
+	for (int square = 0; square < 64; square++)
+	{
+		// white and black share the placement tables except for the pawns
+		int placement[12] = {
+			pawnWhitePlacementTable[square] + closenessToCenterFileBonus[square],
+			knightPlacementTable[square],
+			bishopPlacementTable[square],
+			rookPlacementTable[square],
+			queenPlacementTable[square],
+			kingPlacementTable[square],
+			pawnBlackPlacementTable[square] + closenessToCenterFileBonus[square],
+			knightPlacementTable[square],
+			bishopPlacementTable[square],
+			rookPlacementTable[square],
+			queenPlacementTable[square],
+			kingPlacementTable[square],
+		};
+
+		for (int piece = P; piece <= k; piece++)
+		{
+			midgame[piece][square] = pieceValues[piece % 6] + placement[piece];
+			endgame[piece][square] = midgame[piece][square];
+		}
+		endgame[K][square] = kingEndgamePlacementTable[square];
+		endgame[k][square] = kingEndgamePlacementTable[square];
+	}
+
+	for (int piece = P; piece <= k; piece++)
+	{
+		phase[piece] = piecePhases[piece % 6];
+	}
+}
+
 Model::Model(AttackTables* attackTable, Zobrist* zTables)
 {
 	mIllegalState = 0;
@@ -37,6 +78,7 @@ Model::Model(AttackTables* attackTable, Zobrist* zTables)
 
 	
 	UpdateOccupancies();
+	UpdatePieceScores();
 }
 
 
@@ -70,6 +112,8 @@ Model::Model(AttackTables* attackTable, Zobrist* zTables, int side, int enpassan
 
 	mAttackTables = attackTable;
 	mZobristTables = zTables;
+
+	UpdatePieceScores();
 }
 
 Model::~Model()
@@ -82,6 +126,8 @@ void Model::SetBitboards(std::vector<unsigned long long> bbs)
 	{
 		mBitboards[i] = bbs[i];
 	}
+
+	UpdatePieceScores();
 }
 
 void Model::SetOccupancies(std::vector<unsigned long long> occ)
@@ -279,6 +325,7 @@ void Model::LoadPosition(std::string FEN, Zobrist * zTables)
 	mFullMoves = std::stoi(fullMove);
 
 	UpdateOccupancies();
+	UpdatePieceScores();
 
 	// initialize the hash key
 	mHash = zTables->HashBoard(this);
@@ -440,7 +487,7 @@ int Model::Done(Zobrist * zTables)
 {
 
 	// generate the list of moves
-	std::vector<unsigned long long> moves;
+	std::vector<Move> moves;
 	generateMoves(moves);
 
 	// get indices of legal moves
@@ -469,7 +516,7 @@ int Model::Done(Zobrist * zTables)
 int Model::CheckDrawOrCheckmateOrInPlay(Zobrist * zTables)
 {
 	// generate the moves 
-	std::vector <unsigned long long> moves;
+	std::vector <Move> moves;
 	generateMoves(moves);
 
 	// check if king has a legal move
@@ -540,7 +587,7 @@ void Model::perftTestRecursive(int depth, long& count, long& captures, long& enp
 	else
 	{
 		// make a move list and fill it with moves from the given position
-		std::vector <unsigned long long> moves;
+		std::vector <Move> moves;
 		generateMoves(moves);
 
 		// loop over moves and recursively count their possible positions
@@ -597,7 +644,7 @@ void Model::perftTestRecursive(int depth, long& count, long& captures, long& enp
 
 void Model::perftEachMove(int depth)
 {
-	std::vector <unsigned long long> moves;
+	std::vector <Move> moves;
 
 	generateMoves(moves);
 	long count = 0;
@@ -606,7 +653,7 @@ void Model::perftEachMove(int depth)
 	for (int i = 0; i < moves.size(); i++)
 	{
 		//std::cout << "*************Beginning*******************" << std::endl;
-		std::vector <unsigned long long> newMoves;
+		std::vector <Move> newMoves;
 
 
 		MakeMove(moves[i], allMoves);
@@ -639,4 +686,32 @@ bool Model::OnlyPawns()
 			(!mBitboards[n] && !mBitboards[b] && !mBitboards[r] && !mBitboards[q]));
 }
 
+int Model::PieceCount(int side)
+{
+	// knights, bishops, rooks and queens of one side
+	if (side == white)
+	{
+		return countBits(mBitboards[N] | mBitboards[B] | mBitboards[R] | mBitboards[Q]);
+	}
+	return countBits(mBitboards[n] | mBitboards[b] | mBitboards[r] | mBitboards[q]);
+}
+
+void Model::UpdatePieceScores()
+{
+	mMidgame[white] = mMidgame[black] = 0;
+	mEndgame[white] = mEndgame[black] = 0;
+	mPhase[white] = mPhase[black] = 0;
+
+	for (int piece = P; piece <= k; piece++)
+	{
+		unsigned long long bitboard = mBitboards[piece];
+		while (bitboard)
+		{
+			int square = get_LS1B_index(bitboard);
+			AddPiece(piece, square);
+			clear_bit(bitboard, square);
+		}
+	}
+}
+
 
@@ -3,6 +3,7 @@
 #include "helper.h"
 #include "attack_tables.h"
 #include "zobrist.h"
+#include "piece_square_tables.h"
 
 
 #include <iostream>
@@ -58,8 +59,12 @@ public:
 	void perftEachMove(int depth);
 
 	bool OnlyPawns();
+	int PieceCount(int side);
 
-	inline void generateMoves(std::vector<unsigned long long> &movesList)
+	// recount the piece square scores from the bitboards
+	void UpdatePieceScores();
+
+	inline void generateMoves(std::vector<Move> &movesList)
 	{
 		// define source and target squares
 		int sourceSquare, targetSquare;
@@ -547,6 +552,142 @@ public:
 
 
 
+	// a move for every target square, flagged as a capture where the other side has a piece
+	inline void addMoves(int sourceSquare, unsigned long long targets, int piece, std::vector<Move>& movesList)
+	{
+		while (targets)
+		{
+			int targetSquare = get_LS1B_index(targets);
+			int capture = get_bit(mOccupancies[mSideToMove ^ 1], targetSquare) ? 1 : 0;
+			movesList.push_back(encode_move(sourceSquare, targetSquare, piece, 0, capture, 0, 0, 0));
+			clear_bit(targets, targetSquare);
+		}
+	}
+
+	// a pawn move, one for each piece it can promote to on the last rank
+	inline void addPawnMove(int sourceSquare, int targetSquare, int capture, std::vector<Move>& movesList)
+	{
+		int piece = (mSideToMove == white) ? P : p;
+		if (targetSquare >= a8 || targetSquare <= h1)
+		{
+			int queen = (mSideToMove == white) ? Q : q;
+			movesList.push_back(encode_move(sourceSquare, targetSquare, piece, queen, capture, 0, 0, 0));
+			movesList.push_back(encode_move(sourceSquare, targetSquare, piece, queen - 1, capture, 0, 0, 0));
+			movesList.push_back(encode_move(sourceSquare, targetSquare, piece, queen - 2, capture, 0, 0, 0));
+			movesList.push_back(encode_move(sourceSquare, targetSquare, piece, queen - 3, capture, 0, 0, 0));
+		}
+		else
+		{
+			movesList.push_back(encode_move(sourceSquare, targetSquare, piece, 0, capture, 0, 0, 0));
+		}
+	}
+
+	// only for a side in check: king steps, captures of the checking piece and blocks between it and the king
+	// (pseudo legal like generateMoves, pinned blockers and king steps along the checking line are left to IsIllegal)
+	inline void generateEvasions(std::vector<Move>& movesList)
+	{
+		int side = mSideToMove;
+		int king = (side == white) ? K : k;
+		int kingSquare = get_LS1B_index(mBitboards[king]);
+		unsigned long long checkers = mAttackTables->AttackersTo(kingSquare, mOccupancies[both], mBitboards) & mOccupancies[side ^ 1];
+
+		// the king can always try to step away or take the checker
+		addMoves(kingSquare, mAttackTables->mKingAttacks[kingSquare] & ~mOccupancies[side], king, movesList);
+
+		// from a double check there is no other way out
+		if (!checkers || (checkers & (checkers - 1)))
+		{
+			return;
+		}
+
+		// the other pieces have to land on the checker or between it and the king
+		int checkerSquare = get_LS1B_index(checkers);
+		unsigned long long targets = checkers | mAttackTables->Between(kingSquare, checkerSquare);
+
+		// knights, bishops, rooks and queens
+		for (int piece = king - 4; piece < king; piece++)
+		{
+			unsigned long long bitboard = mBitboards[piece];
+			while (bitboard)
+			{
+				int sourceSquare = get_LS1B_index(bitboard);
+				unsigned long long attacks;
+				if (piece == N || piece == n)
+				{
+					attacks = mAttackTables->mKnightAttacks[sourceSquare];
+				}
+				else if (piece == B || piece == b)
+				{
+					attacks = mAttackTables->getBishopAttacks(sourceSquare, mOccupancies[both]);
+				}
+				else if (piece == R || piece == r)
+				{
+					attacks = mAttackTables->getRookAttacks(sourceSquare, mOccupancies[both]);
+				}
+				else
+				{
+					attacks = mAttackTables->getQueenAttacks(sourceSquare, mOccupancies[both]);
+				}
+				addMoves(sourceSquare, attacks & targets, piece, movesList);
+				clear_bit(bitboard, sourceSquare);
+			}
+		}
+
+		// pawns push into the line or take the checker
+		int pawn = (side == white) ? P : p;
+		int forward = (side == white) ? 8 : -8;
+		unsigned long long bitboard = mBitboards[pawn];
+		while (bitboard)
+		{
+			int sourceSquare = get_LS1B_index(bitboard);
+			int targetSquare = sourceSquare + forward;
+			if (!get_bit(mOccupancies[both], targetSquare))
+			{
+				if (get_bit(targets, targetSquare))
+				{
+					addPawnMove(sourceSquare, targetSquare, 0, movesList);
+				}
+
+				// double push from the starting rank
+				bool startingRank = (side == white) ? (sourceSquare >= a2 && sourceSquare <= h2) : (sourceSquare >= a7 && sourceSquare <= h7);
+				if (startingRank && !get_bit(mOccupancies[both], targetSquare + forward) && get_bit(targets, targetSquare + forward))
+				{
+					movesList.push_back(encode_move(sourceSquare, targetSquare + forward, pawn, 0, 0, 1, 0, 0));
+				}
+			}
+
+			if (mAttackTables->mPawnAttacks[side][sourceSquare] & checkers)
+			{
+				addPawnMove(sourceSquare, checkerSquare, 1, movesList);
+			}
+
+			// en passant takes a checking pawn that has just made its double push
+			if (mEnPassant != noSquare && checkerSquare == mEnPassant - forward &&
+				get_bit(mAttackTables->mPawnAttacks[side][sourceSquare], mEnPassant))
+			{
+				movesList.push_back(encode_move(sourceSquare, mEnPassant, pawn, 0, 1, 0, 1, 0));
+			}
+			clear_bit(bitboard, sourceSquare);
+		}
+	}
+
+	// keep the piece square scores up to date as a piece is put on or taken off a square
+	void inline AddPiece(int piece, int square)
+	{
+		int side = piece < p ? white : black;
+		mMidgame[side] += pieceSquareTables.midgame[piece][square];
+		mEndgame[side] += pieceSquareTables.endgame[piece][square];
+		mPhase[side] += pieceSquareTables.phase[piece];
+	}
+
+	void inline RemovePiece(int piece, int square)
+	{
+		int side = piece < p ? white : black;
+		mMidgame[side] -= pieceSquareTables.midgame[piece][square];
+		mEndgame[side] -= pieceSquareTables.endgame[piece][square];
+		mPhase[side] -= pieceSquareTables.phase[piece];
+	}
+
 	void inline UpdateOccupancies()
 	{
 		mOccupancies[white] = mBitboards[P] | mBitboards[R] | mBitboards[N] | mBitboards[B] | mBitboards[Q] | mBitboards[K];
@@ -554,7 +695,7 @@ public:
 		mOccupancies[both] = mOccupancies[white] | mOccupancies[black];
 	}
 
-	void inline MakeMove(unsigned long long move, int moveFlag)
+	void inline MakeMove(Move move, int moveFlag)
 	{
 		// quiet moves
 		if (moveFlag == allMoves)
@@ -583,6 +724,8 @@ public:
 			// move the piece
 			clear_bit(mBitboards[piece_type], start_square);
 			set_bit(mBitboards[piece_type], destination_square);
+			RemovePiece(piece_type, start_square);
+			AddPiece(piece_type, destination_square);
 
 			// hash piece (remove piece from the start square and put it on the the destination square)
 			mHash ^= mZobristTables->mRandomNumberPieceTable[piece_type][start_square];
@@ -614,6 +757,7 @@ public:
 					if (get_bit(mBitboards[i], destination_square))
 					{
 						clear_bit(mBitboards[i], destination_square);
+						RemovePiece(i, destination_square);
 
 						// store the piece type
 						mLastPieceCaptured.push_back(i);
@@ -633,6 +777,8 @@ public:
 
 				// create a new piece
 				set_bit(mBitboards[promoted_piece_type], destination_square);
+				RemovePiece(piece_type, destination_square);
+				AddPiece(promoted_piece_type, destination_square);
 
 				// unhash the pawn
 				mHash ^= mZobristTables->mRandomNumberPieceTable[piece_type][destination_square];
@@ -648,6 +794,7 @@ public:
 				if (mSideToMove == white)
 				{
 					clear_bit(mBitboards[p], destination_square - 8);
+					RemovePiece(p, destination_square - 8);
 					mLastPieceCaptured.push_back(p);
 
 					// hash the captured piece
@@ -656,6 +803,7 @@ public:
 				else
 				{
 					clear_bit(mBitboards[P], destination_square + 8);
+					RemovePiece(P, destination_square + 8);
 
 					// hash the captured piece
 					mHash ^= mZobristTables->mRandomNumberPieceTable[P][destination_square + 8];
@@ -707,6 +855,8 @@ public:
 						// move H rook
 						clear_bit(mBitboards[R], h1);
 						set_bit(mBitboards[R], f1);
+						RemovePiece(R, h1);
+						AddPiece(R, f1);
 
 						// hash rook move
 						mHash ^= mZobristTables->mRandomNumberPieceTable[R][h1];
@@ -718,6 +868,8 @@ public:
 						// move A rook
 						clear_bit(mBitboards[R], a1);
 						set_bit(mBitboards[R], d1);
+						RemovePiece(R, a1);
+						AddPiece(R, d1);
 
 						// hash rook move
 						mHash ^= mZobristTables->mRandomNumberPieceTable[R][a1];
@@ -728,6 +880,8 @@ public:
 					case (g8):
 						clear_bit(mBitboards[r], h8);
 						set_bit(mBitboards[r], f8);
+						RemovePiece(r, h8);
+						AddPiece(r, f8);
 
 						// hash rook move
 						mHash ^= mZobristTables->mRandomNumberPieceTable[r][h8];
@@ -738,6 +892,8 @@ public:
 					case (c8):
 						clear_bit(mBitboards[r], a8);
 						set_bit(mBitboards[r], d8);
+						RemovePiece(r, a8);
+						AddPiece(r, d8);
 
 						// hash rook move
 						mHash ^= mZobristTables->mRandomNumberPieceTable[r][a8];
@@ -813,7 +969,42 @@ public:
 		}
 	}
 
-	void inline UnmakeMove(unsigned long long move)
+	// pass, the state goes on the same undo stack as a real move's
+	void inline MakeNullMove()
+	{
+		mOldCastleRights.push_back(mCastleRights);
+		mOldEnpassant.push_back(mEnPassant);
+		mOldHalfMoveClock.push_back(mHalfMoveClock);
+		mOldHash.push_back(mHash);
+
+		// the enpassant square goes with the turn
+		if (mEnPassant != noSquare)
+		{
+			mHash ^= mZobristTables->mRandomNumberEnpassantTable[mEnPassant];
+			mEnPassant = noSquare;
+		}
+
+		mHalfMoveClock += 1;
+		mSideToMove ^= 1;
+		mHash ^= mZobristTables->mRandomNumberSide;
+	}
+
+	void inline UnmakeNullMove()
+	{
+		mSideToMove ^= 1;
+
+		mEnPassant = mOldEnpassant[mOldEnpassant.size() - 1];
+		mCastleRights = mOldCastleRights[mOldCastleRights.size() - 1];
+		mHalfMoveClock = mOldHalfMoveClock[mOldHalfMoveClock.size() - 1];
+		mHash = mOldHash[mOldHash.size() - 1];
+
+		mOldEnpassant.pop_back();
+		mOldCastleRights.pop_back();
+		mOldHalfMoveClock.pop_back();
+		mOldHash.pop_back();
+	}
+
+	void inline UnmakeMove(Move move)
 	{
 		// revert to legal
 		mIllegalState = 0;
@@ -841,6 +1032,8 @@ public:
 		// put the moved piece back to the starting square
 		clear_bit(mBitboards[piece_type], destination_square);
 		set_bit(mBitboards[piece_type], start_square);
+		RemovePiece(piece_type, destination_square);
+		AddPiece(piece_type, start_square);
 
 		// if there was a capture, put the old piece back on
 		if (capture_flag)
@@ -857,6 +1050,7 @@ public:
 			if (!enpassant_flag)
 			{
 				set_bit(mBitboards[index], destination_square);
+				AddPiece(index, destination_square);
 			}
 		}
 
@@ -864,6 +1058,10 @@ public:
 		{
 			// remove the promoted piece
 			clear_bit(mBitboards[promoted_piece_type], destination_square);
+			RemovePiece(promoted_piece_type, destination_square);
+
+			// the pawn taken off the destination square above was never on it
+			AddPiece(piece_type, destination_square);
 
 			// put the pawn back to it's starting square
 			set_bit(mBitboards[piece_type], start_square);
@@ -876,10 +1074,12 @@ public:
 			if (mSideToMove == white)
 			{
 				set_bit(mBitboards[p], destination_square - 8);
+				AddPiece(p, destination_square - 8);
 			}
 			else
 			{
 				set_bit(mBitboards[P], destination_square + 8);
+				AddPiece(P, destination_square + 8);
 			}
 		}
 
@@ -894,6 +1094,8 @@ public:
 				// move H rook
 				set_bit(mBitboards[R], h1);
 				clear_bit(mBitboards[R], f1);
+				AddPiece(R, h1);
+				RemovePiece(R, f1);
 				break;
 
 				// white queenside castle
@@ -901,18 +1103,24 @@ public:
 				// move A rook
 				set_bit(mBitboards[R], a1);
 				clear_bit(mBitboards[R], d1);
+				AddPiece(R, a1);
+				RemovePiece(R, d1);
 				break;
 
 				// black kingside castle
 			case (g8):
 				set_bit(mBitboards[r], h8);
 				clear_bit(mBitboards[r], f8);
+				AddPiece(r, h8);
+				RemovePiece(r, f8);
 				break;
 
 				// black queensinde castle
 			case (c8):
 				set_bit(mBitboards[r], a8);
 				clear_bit(mBitboards[r], d8);
+				AddPiece(r, a8);
+				RemovePiece(r, d8);
 				break;
 			}
 		}
@@ -942,6 +1150,11 @@ public:
 	std::vector<unsigned long long> mBitboards;
 	std::vector<unsigned long long> mOccupancies;
 
+	// material and placement of each side's pieces for the midgame and the endgame, and each side's non pawn material
+	int mMidgame[2];
+	int mEndgame[2];
+	int mPhase[2];
+
 private:
 	AttackTables* mAttackTables;
 	Zobrist* mZobristTables;
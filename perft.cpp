@@ -32,7 +32,7 @@ void perftTestRecursive(Model* position, Zobrist* zTables, int depth, long &coun
 	else
 	{
 		// make a move list and fill it with moves from the given position
-		std::vector <unsigned long long> moves;
+		std::vector <Move> moves;
 		position->generateMoves(moves);
 
 		// loop over moves and recursively count their possible positions
@@ -85,7 +85,7 @@ void perftTestRecursive(Model* position, Zobrist* zTables, int depth, long &coun
 
 void perftEachMove(Model* startPosition, Zobrist* zTables, int depth)
 {
-	std::vector <unsigned long long> moves;
+	std::vector <Move> moves;
 
 	startPosition->generateMoves(moves);
 	long count = 0;
@@ -93,7 +93,7 @@ void perftEachMove(Model* startPosition, Zobrist* zTables, int depth)
 	unsigned long long time_start = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 	for (int i = 0; i < moves.size(); i++)
 	{
-		std::vector <unsigned long long> newMoves;
+		std::vector <Move> newMoves;
 
 
 		startPosition->MakeMove(moves[i], allMoves);
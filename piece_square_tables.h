@@ -0,0 +1,120 @@
+#pragma once
+#include "defs.h"
+
+#include <vector>
+
+const std::vector<int> kingPlacementTable = {
+	 2,  20,  19,  0,  0, -2,  20,  0,
+	-2, -2, -2, -3, -3, -3, -2, -2,
+	-4, -4, -4, -4, -4, -4, -4, -4,
+	-5, -5, -5, -5, -5, -5, -5, -5,
+	-5, -5, -5, -5, -5, -5, -5, -5,
+	-4, -4, -4, -4, -4, -4, -4, -4,
+	2, -2, -2, -3, -3, -3, -2, -2,
+	 2,  20,  19,  0,  0, -2,  20,  0,
+};
+
+const std::vector<int> kingEndgamePlacementTable = {
+   -2,-1, 0, 0, 0, 0,-1,-2,
+   -1, 4, 4, 4, 4, 4, 4,-1,
+	0, 4, 6, 6, 6, 6, 4, 0,
+	0, 4, 6, 9, 9, 6, 4, 0,
+	0, 4, 6, 9, 9, 6, 4, 0,
+	0, 4, 6, 6, 6, 6, 4, 0,
+   -1, 4, 4, 4, 4, 4, 4,-1,
+   -2,-1, 0, 0, 0, 0,-1,-2,
+};
+
+
+const std::vector<int> knightPlacementTable = {
+   -3,-1, 0, 0, 0, 0,-1,-3,
+	0, 2, 2, 3, 3, 2, 2, 0,
+   -1, 2, 4, 4, 4, 4, 2,-1,
+	0, 2, 4, 5, 5, 4, 2, 0,
+    0, 2, 4, 5, 5, 4, 2, 0,
+   -1, 2, 4, 4, 4, 4, 2,-1,
+	0, 2, 2, 3, 3, 2, 2, 0,
+   -3,-1, 0, 0, 0, 0,-1,-3,
+};
+
+const std::vector<int> bishopPlacementTable = {
+	3, 2,-1, 3, 3,-1, 2, 3,
+	3, 3, 4, 2, 2, 4, 3, 3,
+	1, 4, 5, 4, 4, 5, 4, 1,
+	1, 3, 4, 5, 5, 4, 3, 1,
+	1, 3, 4, 5, 5, 4, 3, 1,
+	1, 4, 5, 4, 4, 5, 4, 1,
+	3, 3, 4, 2, 2, 4, 3, 3,
+	3, 2,-1, 3, 3,-1, 2, 3,
+};
+
+const std::vector<int> rookPlacementTable = {
+	1, 1, 1, 6, 6, 2, 1, 1,
+	1, 5, 5, 5, 5, 5, 5, 1,
+	1, 3, 3, 4, 4, 3, 3, 1,
+	3, 3, 3, 4, 4, 3, 3, 3,
+	3, 3, 3, 4, 4, 3, 3, 3,
+	1, 3, 3, 4, 4, 3, 3, 1,
+	1, 5, 5, 5, 5, 5, 5, 1,
+	1, 1, 1, 6, 6, 2, 1, 1,
+};
+
+const std::vector<int> pawnWhitePlacementTable = {
+	 0,   0,   0,   0,   0,   0,   0,   0,
+	 1,   1,   1,  -6,  -6,   1,   1,   1,
+	 0,   0,   3,   3,   3,  -5,   0,   0,
+	 0,   0,   3,   7,   7,  -5,  -5,   0,
+	 4,   4,   4,   8,   8,   4,   4,   4,
+	15,  15,  15,  15,  15,  15,  15,  15,
+   100, 100, 100, 100, 100, 100, 100, 100,
+	 0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+const std::vector<int> pawnBlackPlacementTable = {
+	0,   0,   0,   0,   0,   0,   0,   0,
+  100, 100, 100, 100, 100, 100, 100, 100,
+   15,  15,  15,  15,  15,  15,  15,  15,
+	4,   4,   4,   8,   8,   4,   4,   4,
+	0,   0,   3,   7,   7,  -5,  -5,   0,
+	0,   0,   3,   3,   3,  -5,   0,   0,
+	1,   1,   1,  -6,  -6,   1,   1,   1,
+	0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+const std::vector<int> queenPlacementTable = {
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 1, 1, 2, 2, 1, 1, 0,
+	0, 2, 1, 1, 1, 2, 1, 0,
+	0, 1, 1, 3, 3, 1, 1, 0,
+	0, 1, 1, 3, 3, 1, 1, 0,
+	0, 2, 1, 1, 1, 2, 1, 0,
+	0, 1, 1, 2, 2, 1, 1, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+const std::vector<int> closenessToCenterFileBonus = {
+	1, 2, 3, 4, 4, 3, 2, 1,
+	1, 2, 3, 4, 4, 3, 2, 1,
+	1, 2, 3, 4, 4, 3, 2, 1,
+	1, 2, 3, 4, 4, 3, 2, 1,
+	1, 2, 3, 4, 4, 3, 2, 1,
+	1, 2, 3, 4, 4, 3, 2, 1,
+	1, 2, 3, 4, 4, 3, 2, 1,
+	1, 2, 3, 4, 4, 3, 2, 1,
+};
+
+// the material and placement of a piece on each square, the part of the evaluation that
+// only changes when a piece is put on or taken off a square, so the model keeps its sum
+struct PieceSquareTables
+{
+	PieceSquareTables();
+
+	// midgame and endgame scores, only the king's placement differs between the two
+	int midgame[12][64];
+	int endgame[12][64];
+
+	// non pawn material of the piece in pawns, the game phase comes from it
+	int phase[12];
+};
+
+extern const PieceSquareTables pieceSquareTables;
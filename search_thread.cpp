@@ -0,0 +1,1905 @@
+#include "search_thread.h"
+#include "agent.h"
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+SearchThread::SearchThread(Agent* agent) : mModel(&agent->mAttackTables, agent->mZobristTables)
+{
+	mAgent = agent;
+	mAttackTables = &agent->mAttackTables;
+	mZobristTables = agent->mZobristTables;
+	mHashTable = agent->mHashTable;
+	mTTSize = agent->mTTSize;
+
+	mNodes = 0;
+	mSearchNodes = 0;
+	mCutoffs = 0;
+	mFirstMoveCutoffs = 0;
+	mPly = 0;
+	mCurrentDepthStart = 1;
+	mNullMoveMinPly = 0;
+	mFollowPvLine = false;
+	mScorePV = false;
+	mLimits = {};
+	mStartTime = 0;
+	mSoftTimeLimit = 0;
+	mHardTimeLimit = 0;
+	mBaseTimeLimit = 0;
+	mTimePolicy = DEFAULT_TIME_POLICY;
+	mMultiPv = 1;
+	mPondering = false;
+	mPonderHit = false;
+	mPonderHitSignal = &mPonderHit;
+
+	for (int depth = 0; depth < MAX_PLY; depth++)
+	{
+		for (int moveNumber = 0; moveNumber < LMR_MAX_MOVES; moveNumber++)
+		{
+			mReductions[depth][moveNumber] = (depth && moveNumber) ? (int)(LMR_BASE + log(depth) * log(moveNumber) / LMR_DIVISOR) : 0;
+		}
+	}
+
+	ResetKilleHistoryMoves();
+	ResetPVMoves();
+	memset(mStack, 0, sizeof(mStack));
+
+	// a thread of its own until a search makes it somebody's helper
+	mStopSearch = false;
+	mStop = &mStopSearch;
+	mSmpMode = lazySmp;
+	mMainThread = this;
+	mActiveSplit = nullptr;
+	mIdleHelpers = 0;
+	mNextVictim = 0;
+}
+
+void SearchThread::SetPosition(Model const& model, std::unordered_map<unsigned long long, int> const& movesHistory)
+{
+	mModel = model;
+	mMoveHashesHistory = movesHistory;
+}
+
+void SearchThread::LoadPosition(std::string FEN)
+{
+	mModel.LoadPosition(FEN, mZobristTables);
+	mMoveHashesHistory.clear();
+}
+
+void SearchThread::SetStopFlag(std::atomic<bool>* stop)
+{
+	// without a flag of its own to watch the thread goes back to its own
+	mStop = stop ? stop : &mStopSearch;
+}
+
+void SearchThread::SetPonderHitFlag(std::atomic<bool>* ponderHit)
+{
+	mPonderHitSignal = ponderHit ? ponderHit : &mPonderHit;
+}
+
+void SearchThread::SetTimePolicy(TimePolicy const& policy)
+{
+	mTimePolicy = policy;
+}
+
+void SearchThread::SetMultiPv(int lines)
+{
+	mMultiPv = std::max(1, std::min(lines, MAX_MULTI_PV));
+}
+
+void SearchThread::SetHelpers(std::vector<SearchThread*> const& helpers, int smpMode)
+{
+	mHelpers = helpers;
+	mSmpMode = smpMode;
+}
+
+void SearchThread::PrintMoveScores(std::vector<Move> const& moves, int depth)
+{
+	std::cout << "Printing move scores" << std::endl;
+	for (int i = 0; i < moves.size(); i++)
+	{
+		std::cout << "Move: ";
+		printMove(moves[i]);
+		std::cout << " Score: " << scoreMove(moves[i], depth) << std::endl;
+	}
+}
+
+
+int SearchThread::scoreMove(Move move, int depth)
+{
+	// score capture move
+
+	if (mScorePV)
+	{
+		// make sure we have the right PV move
+		if (PvLine(0)[depth] == move)
+		{
+			// disable the scorePV flag
+			mScorePV = false;
+
+			// return a high priority
+			return 20000;
+		}
+	}
+
+	if (decode_capture_flag(move))
+	{
+		int target_piece = CapturedPiece(move);
+
+		// captures of the same victim by the same attacker are told apart by how often they cut off
+		int history = mCaptureHistory[decode_piece_type(move)][decode_destination_square(move)][target_piece % 6] / CAPTURE_HISTORY_DIVISOR;
+
+		// a capture that loses material once the recaptures are played goes after the quiet moves,
+		// taking with the cheaper piece can't lose anything so those skip the exchange
+		if (abs(material_score[decode_piece_type(move)]) > abs(material_score[target_piece]) && StaticExchange(move) < 0)
+		{
+			return mvv_lva[decode_piece_type(move)][target_piece] + history - 10000;
+		}
+
+		// score by MVV LVA lookup
+		return mvv_lva[decode_piece_type(move)][target_piece] + history + 10000;
+	}
+
+	// score quiet move
+	else
+	{
+		// score first killer
+		if (mStack[depth].killers[0] == move)
+		{
+			return 9000;
+		}
+
+		// score second killer
+		else if (mStack[depth].killers[1] == move)
+		{
+			return 8000;
+		}
+		else if (decode_castling_flag(move))
+		{
+			// score castling move
+			return 15000;
+		}
+		// score the move that refuted the opponent's last move
+		else if (depth && mStack[depth - 1].currentMove &&
+			mCounterMoves[decode_piece_type(mStack[depth - 1].currentMove)][decode_destination_square(mStack[depth - 1].currentMove)] == move)
+		{
+			return 7000;
+		}
+		// score history move, scaled to stay under the counter move
+		else
+		{
+			return QuietHistory(move, depth) / 8;
+		}
+	}
+	return 0;
+}
+
+void SearchThread::OrderMoves(std::vector<Move>& moves, int depth)
+{
+	// move scores
+	//std::vector<int> movesScores(moves.size(), 0);
+
+	std::vector<MoveScore> moveScores;
+	// score all the moves within a move list
+	// zip up
+	for (int count = 0; count < moves.size(); count++)
+	{
+		MoveScore a;
+		a.score = scoreMove(moves[count], depth);
+		a.move = moves[count];
+		moveScores.push_back(a);
+		//movesScores[count] = scoreMove(moves[count], state);
+	}
+
+	// sort in descending order
+	std::sort(moveScores.begin(), moveScores.end(), [](const MoveScore a, MoveScore b) {
+		return b < a;
+	});
+
+	// unpack
+	for (int i = 0; i < moves.size(); i++)
+	{
+		moves[i] = moveScores[i].move;
+	}
+}
+
+int SearchThread::CapturedPiece(Move move)
+{
+	// look for the piece on the target square among the other side's bitboards, en passant takes a pawn
+	int startPiece = mModel.mSideToMove == white ? p : P;
+	for (int piece = startPiece; piece <= startPiece + 5; piece++)
+	{
+		if (get_bit(mModel.mBitboards[piece], decode_destination_square(move)))
+		{
+			return piece;
+		}
+	}
+	return startPiece;
+}
+
+int SearchThread::StaticExchange(Move move)
+{
+	int sourceSquare = decode_start_square(move);
+	int targetSquare = decode_destination_square(move);
+	int side = mModel.mSideToMove;
+	std::vector<unsigned long long> const& bitboards = mModel.mBitboards;
+	unsigned long long occupancy = mModel.mOccupancies[both];
+
+	// gain[i] is the material won so far if the sequence stops after capture i
+	int gain[32];
+	int depth = 0;
+
+	// what the move itself takes, en passant takes the pawn beside the target square
+	gain[0] = 0;
+	if (decode_enpassant_flag(move))
+	{
+		gain[0] = material_score[P];
+		clear_bit(occupancy, side == white ? targetSquare - 8 : targetSquare + 8);
+	}
+	else if (decode_capture_flag(move))
+	{
+		gain[0] = abs(material_score[CapturedPiece(move)]);
+	}
+
+	// the piece left standing on the square, a promotion leaves the new piece there
+	int pieceValue = abs(material_score[decode_piece_type(move)]);
+	if (decode_promoted_piece_type(move))
+	{
+		pieceValue = abs(material_score[decode_promoted_piece_type(move)]);
+		gain[0] += pieceValue - material_score[P];
+	}
+
+	unsigned long long diagonalSliders = bitboards[B] | bitboards[b] | bitboards[Q] | bitboards[q];
+	unsigned long long straightSliders = bitboards[R] | bitboards[r] | bitboards[Q] | bitboards[q];
+	unsigned long long attackers = mAttackTables->AttackersTo(targetSquare, occupancy, bitboards);
+	unsigned long long fromBitboard = (unsigned long long)1 << sourceSquare;
+
+	while (fromBitboard && depth < 31)
+	{
+		// the other side takes the piece that just captured
+		depth++;
+		gain[depth] = pieceValue - gain[depth - 1];
+
+		// neither side would carry on from here
+		if (std::max(-gain[depth - 1], gain[depth]) < 0)
+		{
+			break;
+		}
+
+		// take the capturing piece off the board, which can uncover an x-ray attacker behind it
+		occupancy ^= fromBitboard;
+		attackers |= (mAttackTables->getBishopAttacks(targetSquare, occupancy) & diagonalSliders) |
+			(mAttackTables->getRookAttacks(targetSquare, occupancy) & straightSliders);
+		attackers &= occupancy;
+
+		// the least valuable attacker the other side has left captures next
+		side ^= 1;
+		fromBitboard = 0;
+		int startPiece = side == white ? P : p;
+		for (int piece = startPiece; piece <= startPiece + 5; piece++)
+		{
+			unsigned long long pieces = attackers & bitboards[piece];
+			if (pieces)
+			{
+				fromBitboard = pieces & (~pieces + 1);
+				pieceValue = abs(material_score[piece]);
+				break;
+			}
+		}
+	}
+
+	// fold the sequence back up, each side stops capturing as soon as going on would lose
+	while (--depth > 0)
+	{
+		gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+	}
+	return gain[0];
+}
+
+// moves a history entry toward the bonus, the closer it already is to the limit the smaller the step
+static int HistoryGravity(int entry, int bonus)
+{
+	return entry + bonus - entry * abs(bonus) / HISTORY_MAX;
+}
+
+int SearchThread::QuietHistory(Move move, int ply)
+{
+	int piece = decode_piece_type(move);
+	int target = decode_destination_square(move);
+	int score = mButterflyHistory[mModel.mSideToMove][decode_start_square(move)][target];
+
+	// follow-ups of the moves one and two plies back
+	for (int back = 0; back < 2; back++)
+	{
+		if (ply > back && mStack[ply - 1 - back].continuationHistory[back])
+		{
+			score += mStack[ply - 1 - back].continuationHistory[back][piece][target];
+		}
+	}
+	return score;
+}
+
+void SearchThread::SetCurrentMove(int ply, Move move)
+{
+	mStack[ply].currentMove = move;
+
+	// the continuation histories the next two plies look up, a null move has none
+	for (int back = 0; back < 2; back++)
+	{
+		mStack[ply].continuationHistory[back] = move ?
+			mContinuationHistory[back][decode_piece_type(move)][decode_destination_square(move)] : nullptr;
+	}
+}
+
+bool SearchThread::Improving()
+{
+	// the side to move stands better than it did after its last move
+	return !mStack[mPly].inCheck && mPly >= 2 && !mStack[mPly - 2].inCheck && mStack[mPly].staticEval > mStack[mPly - 2].staticEval;
+}
+
+int SearchThread::LateMoveReduction(Move move, int depth, int moveNumber, bool pvNode, bool improving, int inCheck)
+{
+	// the first moves, the root, checks, captures, promotions and killers are searched to full depth
+	if (moveNumber < fullDepthMoves ||
+		depth < reductionLimit ||
+		mPly == 0 ||
+		inCheck ||
+		decode_capture_flag(move) ||
+		decode_promoted_piece_type(move) ||
+		mStack[mPly].killers[0] == move ||
+		mStack[mPly].killers[1] == move)
+	{
+		return 0;
+	}
+
+	int reduction = mReductions[std::min(depth, MAX_PLY - 1)][std::min(moveNumber, LMR_MAX_MOVES - 1)];
+
+	// less on the PV and for moves that have been cutting off elsewhere, more for those that haven't
+	// and while the static eval is going down
+	if (pvNode)
+	{
+		reduction--;
+	}
+	if (!improving)
+	{
+		reduction++;
+	}
+	reduction -= QuietHistory(move, mPly) / LMR_HISTORY_DIVISOR;
+
+	// always leave at least one ply
+	return std::max(0, std::min(reduction, depth - 2));
+}
+
+void SearchThread::UpdateQuietHistory(Move bestMove, std::vector<Move> const& quietsSearched, int depth)
+{
+	// store the killer move
+	if (mStack[mPly].killers[0] != bestMove)
+	{
+		mStack[mPly].killers[1] = mStack[mPly].killers[0];
+		mStack[mPly].killers[0] = bestMove;
+	}
+
+	// store the counter move
+	if (mPly && mStack[mPly - 1].currentMove)
+	{
+		mCounterMoves[decode_piece_type(mStack[mPly - 1].currentMove)][decode_destination_square(mStack[mPly - 1].currentMove)] = bestMove;
+	}
+
+	// reward the move that cut off, penalise the quiet moves searched before it
+	int bonus = std::min(HISTORY_BONUS_SCALE * depth * depth, HISTORY_BONUS_MAX);
+	for (int i = -1; i < (int)quietsSearched.size(); i++)
+	{
+		Move move = i < 0 ? bestMove : quietsSearched[i];
+		int moveBonus = i < 0 ? bonus : -bonus;
+		int piece = decode_piece_type(move);
+		int target = decode_destination_square(move);
+
+		int& butterfly = mButterflyHistory[mModel.mSideToMove][decode_start_square(move)][target];
+		butterfly = HistoryGravity(butterfly, moveBonus);
+
+		for (int back = 0; back < 2; back++)
+		{
+			if (mPly > back && mStack[mPly - 1 - back].continuationHistory[back])
+			{
+				short& continuation = mStack[mPly - 1 - back].continuationHistory[back][piece][target];
+				continuation = HistoryGravity(continuation, moveBonus);
+			}
+		}
+	}
+}
+
+void SearchThread::UpdateCaptureHistory(Move bestMove, std::vector<Move> const& capturesSearched, int depth)
+{
+	// reward the capture that cut off if there is one, penalise the captures searched before the cutoff
+	int bonus = std::min(HISTORY_BONUS_SCALE * depth * depth, HISTORY_BONUS_MAX);
+	for (int i = bestMove ? -1 : 0; i < (int)capturesSearched.size(); i++)
+	{
+		Move move = i < 0 ? bestMove : capturesSearched[i];
+		short& entry = mCaptureHistory[decode_piece_type(move)][decode_destination_square(move)][CapturedPiece(move) % 6];
+		entry = HistoryGravity(entry, i < 0 ? bonus : -bonus);
+	}
+}
+
+void SearchThread::ResetKilleHistoryMoves()
+{
+	ResetKillerMoves();
+
+	// reset the history tables
+	memset(mButterflyHistory, 0, sizeof(mButterflyHistory));
+	memset(mCounterMoves, 0, sizeof(mCounterMoves));
+	memset(mContinuationHistory, 0, sizeof(mContinuationHistory));
+	memset(mCaptureHistory, 0, sizeof(mCaptureHistory));
+}
+
+void SearchThread::ResetKillerMoves()
+{
+	// reset the killer moves
+	for (int ply = 0; ply < MAX_PLY; ply++)
+	{
+		mStack[ply].killers[0] = 0;
+		mStack[ply].killers[1] = 0;
+	}
+}
+
+void SearchThread::ResetPVMoves()
+{
+
+	// reset pv length
+	for (int i = 0; i < MAX_PLY; i++)
+	{
+		mPvLength[i] = 0;
+	}
+
+	// reset pv table
+	memset(mPvTable, 0, sizeof(mPvTable));
+}
+
+int SearchThread::CountLegalMoves()
+{
+	std::vector<Move> moves;
+	mModel.generateMoves(moves);
+
+	int legalMoves = 0;
+	for (int i = 0; i < moves.size(); i++)
+	{
+		mModel.MakeMove(moves[i], allMoves);
+		if (!mModel.IsIllegal())
+		{
+			legalMoves++;
+		}
+		mModel.UnmakeMove(moves[i]);
+	}
+	return legalMoves;
+}
+
+bool SearchThread::ReadHash(TT_Entry& entry)
+{
+	// get the hash entry for the current position if it exists
+	// (copied, another thread may be writing the same slot)
+	entry = mHashTable[mModel.mHash % mTTSize];
+
+	// verify that we have the right position
+	return (entry.hash_key ^ HashEntryData(entry.depth, entry.flags, entry.value, entry.move)) == mModel.mHash;
+}
+
+int SearchThread::ProbeHash(int alpha, int beta, int depth)
+{
+	TT_Entry entry;
+	if (ReadHash(entry))
+	{
+		// verify the depth of the entry
+		if (entry.depth >= depth)
+		{
+			// match what the entry has
+			if (entry.flags == HASH_FLAG_EXACT)
+			{
+				//std::cout << "exact score: " << std::endl;
+				return entry.value;
+			}
+			if ((entry.flags == HASH_FLAG_ALPHA) &&
+				(entry.value <= alpha))
+			{
+				//std::cout << "alpha score: " << std::endl;
+				return alpha;
+			}
+			if ((entry.flags == HASH_FLAG_BETA) &&
+				(entry.value >= beta))
+			{
+				//std::cout << "beta score: " << std::endl;
+				return beta;
+			}
+		}
+	}
+	// return something out of bounds
+	return NO_HASH_ENTRY;
+}
+
+void SearchThread::RecordHash(int score, int depth, int hashFlag, Move move)
+{
+	// a node searched with some of its moves left out doesn't have the position's real score
+	if ((mPly == 0 && mExcludedRootMoves.size()) || mStack[mPly].excludedMove)
+	{
+		return;
+	}
+
+	// a search that found no best move keeps the one already stored for the position
+	PackedMove packedMove = pack_move(move);
+	TT_Entry previous;
+	if (packedMove == 0 && ReadHash(previous))
+	{
+		packedMove = previous.move;
+	}
+
+	// the entry keeps the depth in a byte
+	depth = std::min(depth, 255);
+
+	// get the correct entry for the hash
+	TT_Entry* entry = &mHashTable[mModel.mHash % mTTSize];
+
+	// write the entry data
+	entry->hash_key = mModel.mHash ^ HashEntryData(depth, hashFlag, score, packedMove);
+	entry->value = score;
+	entry->flags = hashFlag;
+	entry->depth = depth;
+	entry->move = packedMove;
+}
+
+void SearchThread::EnablePvScoring(std::vector<Move> const& moves, int ply)
+{
+	// disable following PV
+	mFollowPvLine = false;
+
+	// loop over the moves
+	for (int i = 0; i < moves.size(); i++)
+	{
+		// make sure we hit PV move
+		if (PvLine(0)[ply] == moves[i])
+		{
+			mScorePV = true;
+			mFollowPvLine = true;
+		}
+	}
+}
+
+SearchResult SearchThread::SearchNegamax(SearchLimits const& limits)
+{
+	return Analyse(limits, true);
+}
+
+SearchResult SearchThread::Analyse(SearchLimits const& limits, bool printInfo)
+{
+	SearchResult result = { 0, 0, 0, 0, {}, {}, 0, 0, 0, 0 };
+
+	mLimits = limits;
+	SetTimeLimits(limits);
+	mPondering = limits.ponder;
+
+	// only matters when searching alone, the agent looks after its own flag
+	mStopSearch = false;
+	mNodes = 0;
+	mSearchNodes = 0;
+	mCutoffs = 0;
+	mFirstMoveCutoffs = 0;
+	mFollowPvLine = false;
+	mScorePV = false;
+	ResetPVMoves();
+
+	// the helpers start once the limits are set, they check them through this thread
+	StartHelpers();
+
+	// an iteration can't go deeper than the search stack
+	int maxDepth = limits.depth ? std::min(limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+
+	// root statistics for the time policy
+	int stableIterations = 0;
+
+	// can't show more lines than there are moves
+	int lineCount = std::max(1, std::min(mMultiPv, CountLegalMoves()));
+
+	// the histories carry over from one iteration to the next, the killers start afresh
+	ResetKilleHistoryMoves();
+	for (int i = 1; i <= maxDepth; i++)
+	{
+		ResetKillerMoves();
+		mCurrentDepthStart = i;
+
+		// search the root once per line, the moves already in a line are excluded and the TT carries the work over
+		std::vector<SearchLine> lines;
+		mExcludedRootMoves.clear();
+		for (int line = 0; line < lineCount; line++)
+		{
+			// aspiration window around the score this line had last iteration
+			int delta = ASPIRATION_WINDOW;
+			int alpha = -50000;
+			int beta = 50000;
+			if (i >= ASPIRATION_MIN_DEPTH && line < result.lines.size())
+			{
+				alpha = std::max(-50000, result.lines[line].score - delta);
+				beta = std::min(50000, result.lines[line].score + delta);
+			}
+
+			int lineScore;
+			while (true)
+			{
+				// follow this line's PV from the last iteration
+				if (line < result.lines.size())
+				{
+					for (int count = 0; count < result.lines[line].pv.size(); count++)
+					{
+						PvLine(0)[count] = result.lines[line].pv[count];
+					}
+					mPvLength[0] = result.lines[line].pv.size();
+				}
+
+				// enable follow PV flag
+				mFollowPvLine = true;
+
+				lineScore = Negamax(alpha, beta, i);
+				if (SearchAborted())
+				{
+					break;
+				}
+
+				// outside the window the score is only a bound and there is no PV, widen the side that failed and search again
+				if (lineScore <= alpha && alpha > -50000)
+				{
+					alpha = std::max(-50000, alpha - delta);
+					result.failLows++;
+				}
+				else if (lineScore >= beta && beta < 50000)
+				{
+					beta = std::min(50000, beta + delta);
+					result.failHighs++;
+				}
+				else
+				{
+					break;
+				}
+				delta *= 2;
+			}
+			if (SearchAborted())
+			{
+				break;
+			}
+
+			lines.push_back({ lineScore, std::vector<Move>(PvLine(0), PvLine(0) + mPvLength[0]) });
+			mExcludedRootMoves.push_back(PvLine(0)[0]);
+		}
+		mExcludedRootMoves.clear();
+
+		// stopped part way through, keep the moves from the last full iteration
+		if (SearchAborted())
+		{
+			break;
+		}
+
+		// a later line can come back better than an earlier one
+		std::stable_sort(lines.begin(), lines.end(), [](SearchLine const& a, SearchLine const& b) {
+			return a.score > b.score;
+		});
+		int score = lines[0].score;
+		Move bestMove = lines[0].pv.size() ? lines[0].pv[0] : 0;
+
+		// compare with the previous iteration before overwriting it
+		bool bestMoveChanged = i > 1 && bestMove != result.bestMove;
+		int scoreDrop = i > 1 ? result.score - score : 0;
+		stableIterations = bestMoveChanged ? 0 : stableIterations + 1;
+
+		result.bestMove = bestMove;
+		result.score = score;
+		result.depth = i;
+		result.pv = lines[0].pv;
+		result.lines = lines;
+
+		if (printInfo)
+		{
+			for (int line = 0; line < lines.size(); line++)
+			{
+				// one write per line, the UCI thread may be answering "isready" at the same time,
+				// nodes are those of every thread, plus what this thread hasn't passed on to the total yet
+				std::string info = "info depth " + std::to_string(i) + " multipv " + std::to_string(line + 1) +
+					" score " + scoreToString(lines[line].score) +
+					" nodes " + std::to_string(mSearchNodes + (mNodes & (NODE_CHECK_INTERVAL - 1))) +
+					" time " + std::to_string(ElapsedTime()) + " pv ";
+
+				// loop oever PV line
+				for (int count = 0; count < lines[line].pv.size(); count++)
+				{
+					info += moveToString(lines[line].pv[count]) + " ";
+				}
+				std::cout << info + "\n" << std::flush;
+			}
+		}
+
+		// no need to look any further once a mate is found
+		if (score > 45000 || score < -45000)
+		{
+			break;
+		}
+
+		// the next iteration would take several times longer than this one, don't start it past the soft limit
+		AdjustTimeLimit(stableIterations, bestMoveChanged, scoreDrop);
+		if (!Pondering() && mSoftTimeLimit && ElapsedTime() >= mSoftTimeLimit)
+		{
+			break;
+		}
+	}
+	result.nodes = mNodes;
+	result.cutoffs = mCutoffs;
+	result.firstMoveCutoffs = mFirstMoveCutoffs;
+
+	// "go infinite" only ends on "stop", even when there is nothing left to search, and pondering also on "ponderhit"
+	while ((limits.infinite || Pondering()) && !mStop->load())
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	// and stop before the limits are cleared, their nodes count towards the search's
+	if (mHelpers.size())
+	{
+		result.nodes += StopHelpers();
+	}
+
+	mLimits = {};
+	mSoftTimeLimit = 0;
+	mHardTimeLimit = 0;
+	mBaseTimeLimit = 0;
+	mPondering = false;
+	return result;
+}
+
+void SearchThread::SetTimeLimits(SearchLimits const& limits)
+{
+	mStartTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	mSoftTimeLimit = 0;
+	mHardTimeLimit = 0;
+
+	if (limits.infinite)
+	{
+		return;
+	}
+
+	// a fixed time for the move
+	if (limits.movetime)
+	{
+		mHardTimeLimit = std::max(1ULL, limits.movetime - std::min(limits.movetime - 1, (unsigned long long)MOVE_OVERHEAD));
+		mSoftTimeLimit = mHardTimeLimit;
+		return;
+	}
+
+	// playing on a clock
+	int side = mModel.mSideToMove;
+	if (limits.time[side])
+	{
+		unsigned long long available = std::max(1ULL, limits.time[side] - std::min(limits.time[side] - 1, (unsigned long long)MOVE_OVERHEAD));
+		int movesToGo = limits.movestogo ? limits.movestogo : DEFAULT_MOVES_TO_GO;
+
+		// aim for an even share of the clock plus most of the increment
+		mSoftTimeLimit = available / movesToGo + limits.increment[side] * 3 / 4;
+
+		// but never sink more than a few moves' worth, or most of what is left, into one move
+		mHardTimeLimit = std::min(available * 4 / 5, mSoftTimeLimit * 5);
+		mSoftTimeLimit = std::max(1ULL, std::min(mSoftTimeLimit, mHardTimeLimit));
+		mHardTimeLimit = std::max(1ULL, mHardTimeLimit);
+
+		// only a clock leaves room to move the soft limit around
+		mBaseTimeLimit = mSoftTimeLimit;
+	}
+	else if (!limits.depth && !limits.nodes)
+	{
+		// no clock of our own and no other limit, don't search forever
+		mHardTimeLimit = DEFAULT_MOVE_TIME - MOVE_OVERHEAD;
+		mSoftTimeLimit = mHardTimeLimit;
+	}
+}
+
+void SearchThread::AdjustTimeLimit(int stableIterations, bool bestMoveChanged, int scoreDrop)
+{
+	if (!mTimePolicy.adaptive || !mBaseTimeLimit)
+	{
+		return;
+	}
+
+	unsigned long long limit = mBaseTimeLimit;
+
+	// a settled best move is unlikely to change with one more iteration
+	if (stableIterations >= mTimePolicy.stableIterations)
+	{
+		limit = limit * mTimePolicy.stableFactor / 100;
+	}
+
+	// a new best move or a falling score means the last iteration found something, look further
+	if (bestMoveChanged)
+	{
+		limit = limit * mTimePolicy.instabilityFactor / 100;
+	}
+	if (scoreDrop > mTimePolicy.scoreDropMargin)
+	{
+		limit = limit * mTimePolicy.scoreDropFactor / 100;
+	}
+
+	mSoftTimeLimit = std::max(1ULL, std::min(limit, mHardTimeLimit));
+}
+
+unsigned long long SearchThread::ElapsedTime()
+{
+	unsigned long long time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	return time - mStartTime;
+}
+
+bool SearchThread::Pondering()
+{
+	// the opponent played the move we were pondering on, our clock starts now
+	if (mPondering && mPonderHitSignal->load())
+	{
+		mPondering = false;
+		mStartTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	}
+	return mPondering;
+}
+
+void SearchThread::CheckLimits(unsigned long long nodes)
+{
+	mSearchNodes += nodes;
+	if (mLimits.nodes && mSearchNodes >= mLimits.nodes)
+	{
+		*mStop = true;
+	}
+
+	if (!Pondering() && mHardTimeLimit && ElapsedTime() >= mHardTimeLimit)
+	{
+		*mStop = true;
+	}
+}
+
+void SearchThread::StartHelpers()
+{
+	for (int i = 0; i < mHelpers.size(); i++)
+	{
+		// give the helper its own copy of the root position and tie it to this search
+		mHelpers[i]->mModel = mModel;
+		mHelpers[i]->mMoveHashesHistory = mMoveHashesHistory;
+		mHelpers[i]->mStop = mStop;
+		mHelpers[i]->mMainThread = this;
+		mHelpers[i]->mSmpMode = mSmpMode;
+
+		if (mSmpMode == youngBrothersWait)
+		{
+			// helpers wait for split points instead of searching the root themselves
+			mHelperThreads.push_back(std::thread(&SearchThread::HelperIdleLoop, mHelpers[i]));
+		}
+		else
+		{
+			mHelperThreads.push_back(std::thread(&SearchThread::HelperSearch, mHelpers[i], i + 1));
+		}
+	}
+}
+
+unsigned long long SearchThread::StopHelpers()
+{
+	unsigned long long nodes = 0;
+
+	// raise the flag and wait for every helper to unwind
+	*mStop = true;
+	for (int i = 0; i < mHelperThreads.size(); i++)
+	{
+		mHelperThreads[i].join();
+		nodes += mHelpers[i]->mNodes;
+
+		// the helper goes back to the pool as a thread of its own
+		mHelpers[i]->mStop = &mHelpers[i]->mStopSearch;
+		mHelpers[i]->mMainThread = mHelpers[i];
+	}
+	mHelperThreads.clear();
+	*mStop = false;
+
+	return nodes;
+}
+
+void SearchThread::HelperSearch(int threadIndex)
+{
+	mNodes = 0;
+	ResetPVMoves();
+
+	// stagger the helpers, odd threads start one ply ahead of the main thread
+	ResetKilleHistoryMoves();
+	for (int i = 1 + (threadIndex & 1); i < MAX_PLY; i++)
+	{
+		ResetKillerMoves();
+		mFollowPvLine = true;
+		mCurrentDepthStart = i;
+
+		Negamax(-50000, 50000, i);
+
+		if (mStop->load(std::memory_order_relaxed))
+		{
+			break;
+		}
+	}
+}
+
+void SearchThread::HelperIdleLoop()
+{
+	mNodes = 0;
+	ResetKilleHistoryMoves();
+	ResetPVMoves();
+	mActiveSplit = nullptr;
+
+	mMainThread->mIdleHelpers++;
+	while (!mStop->load(std::memory_order_relaxed))
+	{
+		// look for work at the split points of the other threads
+		SplitPoint* sp = StealSplitPoint();
+		if (sp == nullptr)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		// take a copy of the node and search moves from it until there are none left
+		mModel = sp->position;
+		std::copy(sp->stack.begin(), sp->stack.end(), mStack);
+		for (int ply = 0; ply < sp->stack.size(); ply++)
+		{
+			// point at this thread's own continuation histories
+			SetCurrentMove(ply, mStack[ply].currentMove);
+		}
+		mCurrentDepthStart = sp->currentDepthStart;
+		mFollowPvLine = false;
+		mScorePV = false;
+		SearchSplitPoint(sp);
+
+		// the owner may free the split point as soon as we leave it
+		{
+			std::lock_guard<std::mutex> guard(sp->lock);
+			sp->workers--;
+		}
+		mMainThread->mIdleHelpers++;
+	}
+	mMainThread->mIdleHelpers--;
+}
+
+SplitPoint* SearchThread::StealSplitPoint()
+{
+	// visit the threads of the search in turn, carrying on after the last victim so that thieves spread out
+	int threads = mMainThread->mHelpers.size() + 1;
+	for (int i = 0; i < threads; i++)
+	{
+		mNextVictim = (mNextVictim + 1) % threads;
+		SearchThread* victim = mNextVictim ? mMainThread->mHelpers[mNextVictim - 1] : mMainThread;
+		std::lock_guard<std::mutex> guard(victim->mSplitLock);
+
+		// steal from the victim's split point with the most depth left that still has moves to hand out,
+		// the biggest piece of work, which is usually the one nearest the root
+		SplitPoint* best = nullptr;
+		for (int j = 0; j < victim->mSplitPoints.size(); j++)
+		{
+			SplitPoint* sp = victim->mSplitPoints[j];
+			std::lock_guard<std::mutex> spGuard(sp->lock);
+			if (!sp->cutoff && sp->nextMove < sp->moves.size() && (best == nullptr || sp->depth > best->depth))
+			{
+				best = sp;
+			}
+		}
+
+		// join while the victim's list is still locked, so that the owner can't take the split point down first
+		if (best != nullptr)
+		{
+			std::lock_guard<std::mutex> spGuard(best->lock);
+			best->workers++;
+			mMainThread->mIdleHelpers--;
+			return best;
+		}
+	}
+	return nullptr;
+}
+
+int SearchThread::Split(std::vector<Move> const& moves, int firstMove, int alpha, int beta, int depth, int inCheck, Move& bestMove)
+{
+	SplitPoint sp(mModel);
+	sp.parent = mActiveSplit;
+	sp.owner = this;
+	sp.moves = moves;
+	sp.nextMove = firstMove;
+	sp.alpha = alpha;
+	sp.beta = beta;
+	sp.depth = depth;
+	sp.ply = mPly;
+	sp.currentDepthStart = mCurrentDepthStart;
+	sp.inCheck = inCheck;
+	sp.nullMoveMinPly = mNullMoveMinPly;
+	sp.stack.assign(mStack, mStack + mPly + 1);
+	sp.bestMove = 0;
+	sp.workers = 1;
+	sp.cutoff = false;
+
+	// publish the split point in our own list
+	{
+		std::lock_guard<std::mutex> guard(mSplitLock);
+		mSplitPoints.push_back(&sp);
+	}
+
+	// the owner picks moves like any other thread
+	SearchSplitPoint(&sp);
+
+	// nothing left to hand out, take it down and wait for the helpers still searching
+	{
+		std::lock_guard<std::mutex> guard(mSplitLock);
+		mSplitPoints.erase(std::find(mSplitPoints.begin(), mSplitPoints.end(), &sp));
+	}
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> guard(sp.lock);
+			if (sp.workers == 1)
+			{
+				break;
+			}
+		}
+
+		// no nodes are searched while we wait, the clock still has to be watched
+		mMainThread->CheckLimits(0);
+		std::this_thread::yield();
+	}
+
+	// copy the best line into our PV table
+	if (sp.pv.size())
+	{
+		for (int i = 0; i < sp.pv.size(); i++)
+		{
+			PvLine(mPly)[mPly + i] = sp.pv[i];
+		}
+		mPvLength[mPly] = mPly + sp.pv.size();
+	}
+
+	bestMove = sp.bestMove;
+	return sp.cutoff ? beta : sp.alpha;
+}
+
+void SearchThread::SearchSplitPoint(SplitPoint* sp)
+{
+	SplitPoint* oldSplit = mActiveSplit;
+	int oldPly = mPly;
+	int oldNullMoveMinPly = mNullMoveMinPly;
+	mActiveSplit = sp;
+	mPly = sp->ply;
+	mNullMoveMinPly = sp->nullMoveMinPly;
+
+	int depth = sp->depth;
+	int score;
+
+	while (!SearchAborted())
+	{
+		// pick our next move and the current bound
+		Move move;
+		int alpha;
+		int beta = sp->beta;
+		int moveIndex;
+		{
+			std::lock_guard<std::mutex> guard(sp->lock);
+			if (sp->nextMove >= sp->moves.size())
+			{
+				break;
+			}
+			moveIndex = sp->nextMove++;
+			move = sp->moves[moveIndex];
+			alpha = sp->alpha;
+		}
+
+		int reduction = LateMoveReduction(move, depth, moveIndex, beta - alpha > 1, Improving(), sp->inCheck);
+
+		SetCurrentMove(mPly, move);
+		mPly++;
+		mModel.MakeMove(move, allMoves);
+		if (mModel.IsIllegal())
+		{
+			mModel.UnmakeMove(move);
+			mPly--;
+			continue;
+		}
+
+		// the eldest brother is already searched, so try to prove the rest are worse
+		if (reduction)
+		{
+			score = -Negamax(-alpha - 1, -alpha, depth - 1 - reduction);
+		}
+		else
+		{
+			score = alpha + 1;
+		}
+
+		if (score > alpha)
+		{
+			score = -Negamax(-alpha - 1, -alpha, depth - 1);
+			if ((score > alpha) && (score < beta))
+			{
+				score = -Negamax(-beta, -alpha, depth - 1);
+			}
+		}
+
+		mPly--;
+		mModel.UnmakeMove(move);
+
+		if (SearchAborted())
+		{
+			break;
+		}
+
+		std::lock_guard<std::mutex> guard(sp->lock);
+		if (score > sp->alpha)
+		{
+			sp->alpha = score;
+			sp->bestMove = move;
+
+			// move plus the line below it
+			sp->pv.clear();
+			sp->pv.push_back(move);
+			for (int nextPly = mPly + 1; nextPly < mPvLength[mPly + 1]; nextPly++)
+			{
+				sp->pv.push_back(PvLine(mPly + 1)[nextPly]);
+			}
+
+			if (score >= sp->beta)
+			{
+				sp->cutoff = true;
+			}
+		}
+	}
+
+	mActiveSplit = oldSplit;
+	mPly = oldPly;
+	mNullMoveMinPly = oldNullMoveMinPly;
+}
+
+bool SearchThread::SearchAborted()
+{
+	// the first iteration always completes so that there is a move to report
+	if (mCurrentDepthStart > 1 && mStop->load(std::memory_order_relaxed))
+	{
+		return true;
+	}
+
+	// a fail-high at any split point above us makes our result useless
+	for (SplitPoint* sp = mActiveSplit; sp != nullptr; sp = sp->parent)
+	{
+		if (sp->cutoff.load(std::memory_order_relaxed))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+
+int SearchThread::Negamax(int alpha, int beta, int depth)
+{
+	// define score variable
+	int score;
+
+	// set the hash flag for the transposition table
+	int hashf = HASH_FLAG_ALPHA;
+
+	// the move that raised alpha, stored with the hash
+	Move bestMove = 0;
+
+	// another thread ended the search, the result is thrown away
+	if (SearchAborted())
+	{
+		return 0;
+	}
+
+	// init PV length
+	mPvLength[mPly] = mPly;
+
+	// read transposition table
+	
+	
+	
+	// transposition table lookup (never at the root, where we need a move and not just a score,
+	// nor while a move is left out, the stored score counts that move)
+	if (mPly && !mStack[mPly].excludedMove && (score = ProbeHash(alpha, beta, depth)) != NO_HASH_ENTRY)
+	{
+		// return the value if the position has been searched before
+		//std::cout << "here" << std::endl;
+
+		if (score == 49000)
+			return score - mPly;
+		if (score == -49000)
+			return score + mPly;
+
+		return score;
+	}
+	
+
+	// if this position has been repeated before, return 0 (avoids repeats if winning)
+	if (mMoveHashesHistory.count(mModel.GetHash()) && mPly != 0)
+	{
+		return 0;
+	}
+
+	// recursion escape condition
+	if (depth <= 0 || mPly >= MAX_PLY - 1)
+	{
+		//return EvalNegamax();
+		return QuiescenceNegamax(alpha, beta, depth);
+	}
+
+	// increment nodes count
+	mNodes++;
+
+	// look at the clock and the node budget every so often, the main thread holds the limits for all threads
+	if ((mNodes & (NODE_CHECK_INTERVAL - 1)) == 0)
+	{
+		mMainThread->CheckLimits(NODE_CHECK_INTERVAL);
+	}
+
+
+	// number of moves searched in a move list
+	int movesSearched = 0;
+
+	// count the legal moves
+	int legalMoves = 0;
+
+	// quiet moves and captures searched so far
+	std::vector<Move> quietsSearched;
+	std::vector<Move> capturesSearched;
+
+	// in-check state of the side to move
+	int sideToMove = mModel.mSideToMove;
+	unsigned long long kingBitboard = (sideToMove == white) ? mModel.mBitboards[K] : mModel.mBitboards[k];
+	int inCheck = mAttackTables->SquareAttacked(get_LS1B_index(kingBitboard), sideToMove ^ 1,
+		mModel.mBitboards, mModel.mOccupancies);
+
+	if (inCheck)
+	{
+		depth++;
+	}
+
+	// pruning near the leaves works from the static evaluation, and only off the PV and out of check
+	bool pvNode = beta - alpha > 1;
+	int staticEval = inCheck ? NO_EVAL : mAgent->Evaluate(mModel);
+	mStack[mPly].staticEval = staticEval;
+	mStack[mPly].inCheck = inCheck;
+	bool improving = Improving();
+
+	// not in the singular extension search, it must look at the other moves rather than stand on the static eval
+	bool futile = false;
+	if (!pvNode && !inCheck && mPly && depth <= REVERSE_FUTILITY_DEPTH && !mStack[mPly].excludedMove)
+	{
+		// reverse futility, so far above beta that the opponent can't be expected to get back under it
+		if (beta > -45000 && beta < 45000 && staticEval - REVERSE_FUTILITY_MARGIN * depth >= beta)
+		{
+			return beta;
+		}
+
+		// frontier and extended futility, so far below alpha that only captures, promotions and checks are worth a look
+		futile = depth <= 2 && alpha > -45000 && alpha < 45000 && staticEval + FUTILITY_MARGIN[depth] <= alpha;
+	}
+	
+	
+	// Null move pruning, the side to move needs a piece or two so that passing isn't its best option (zugzwang)
+	if (!pvNode && depth >= NULL_MOVE_DEPTH && !inCheck && mPly && mPly >= mNullMoveMinPly && mStack[mPly - 1].currentMove &&
+		!mStack[mPly].excludedMove && mModel.PieceCount(sideToMove))
+	{
+		if (staticEval >= beta)
+		{
+			// reduce more the deeper the node and the further the eval is above beta
+			int reduction = NULL_MOVE_REDUCTION + depth / NULL_MOVE_DEPTH_DIVISOR +
+				std::min((staticEval - beta) / NULL_MOVE_EVAL_DIVISOR, NULL_MOVE_MAX_EVAL_REDUCTION);
+			int nullDepth = std::max(0, depth - 1 - reduction);
+
+			// make a null move, literally give an opponent a free move
+			mModel.MakeNullMove();
+			SetCurrentMove(mPly, 0);
+			mPly++;
+
+			score = -Negamax(-beta, -beta + 1, nullDepth);
+
+			mPly--;
+			mModel.UnmakeNullMove();
+
+			if (SearchAborted())
+			{
+				return 0;
+			}
+
+			if (score >= beta)
+			{
+				// deep nodes and thin material, search the node again without null moves before trusting the cutoff
+				if (depth >= NULL_MOVE_VERIFY_DEPTH || mModel.PieceCount(sideToMove) <= NULL_MOVE_VERIFY_PIECES)
+				{
+					int oldMinPly = mNullMoveMinPly;
+					mNullMoveMinPly = mPly + 3 * nullDepth / 4 + 1;
+					score = Negamax(beta - 1, beta, nullDepth);
+					mNullMoveMinPly = oldMinPly;
+
+					if (SearchAborted())
+					{
+						return 0;
+					}
+				}
+
+				// fail hard beta cutoff
+				if (score >= beta)
+				{
+					return beta;
+				}
+			}
+		}
+	}
+
+	// the hash move is searched first
+	TT_Entry ttEntry;
+	bool ttHit = ReadHash(ttEntry);
+	PackedMove ttMove = ttHit ? ttEntry.move : 0;
+
+	// ProbCut, a good enough capture makes a fail-high close to certain,
+	// unless the table already knows a search about as deep stayed under the raised beta
+	int probCutBeta = beta + PROBCUT_MARGIN;
+	if (!pvNode && depth >= PROBCUT_DEPTH && !inCheck && mPly && !mStack[mPly].excludedMove &&
+		beta > -45000 && probCutBeta < 45000 &&
+		!(ttHit && ttEntry.flags != HASH_FLAG_BETA && ttEntry.depth >= depth - PROBCUT_REDUCTION + 1 && ttEntry.value < probCutBeta))
+	{
+		std::vector<Move> generated;
+		mModel.generateMoves(generated);
+
+		// the quiet moves are dropped before ordering, scoring them would be wasted
+		std::vector<Move> captures;
+		for (int count = 0; count < generated.size(); count++)
+		{
+			if (decode_capture_flag(generated[count]))
+			{
+				captures.push_back(generated[count]);
+			}
+		}
+		OrderMoves(captures, mPly);
+
+		for (int count = 0; count < captures.size(); count++)
+		{
+			// only captures that win at least what the static eval is short of the raised beta
+			if (StaticExchange(captures[count]) < probCutBeta - staticEval)
+			{
+				continue;
+			}
+
+			SetCurrentMove(mPly, captures[count]);
+			mPly++;
+			mModel.MakeMove(captures[count], allMoves);
+			if (mModel.IsIllegal())
+			{
+				mModel.UnmakeMove(captures[count]);
+				mPly--;
+				continue;
+			}
+
+			// the quiescence search is cheap, only a capture that holds up there gets the reduced search
+			score = -QuiescenceNegamax(-probCutBeta, -probCutBeta + 1, 0);
+			if (score >= probCutBeta)
+			{
+				score = -Negamax(-probCutBeta, -probCutBeta + 1, depth - PROBCUT_REDUCTION);
+			}
+
+			mPly--;
+			mModel.UnmakeMove(captures[count]);
+
+			if (SearchAborted())
+			{
+				return 0;
+			}
+
+			if (score >= probCutBeta)
+			{
+				RecordHash(score, depth - PROBCUT_REDUCTION + 1, HASH_FLAG_BETA, captures[count]);
+				return beta;
+			}
+		}
+	}
+
+	// singular extension, the hash move is searched a ply deeper when no other move comes close to its score
+	bool singular = false;
+	if (depth >= SINGULAR_DEPTH && mPly && !mStack[mPly].excludedMove && ttMove &&
+		ttEntry.flags != HASH_FLAG_ALPHA && ttEntry.depth >= depth - SINGULAR_TT_DEPTH &&
+		ttEntry.value > -45000 && ttEntry.value < 45000)
+	{
+		int singularBeta = ttEntry.value - SINGULAR_MARGIN * depth;
+
+		mStack[mPly].excludedMove = ttMove;
+		score = Negamax(singularBeta - 1, singularBeta, (depth - 1) / 2);
+		mStack[mPly].excludedMove = 0;
+
+		if (SearchAborted())
+		{
+			return 0;
+		}
+
+		if (score < singularBeta)
+		{
+			singular = true;
+		}
+		// multi-cut, another move beats beta as well so the node is going to fail high anyway
+		else if (singularBeta >= beta)
+		{
+			return beta;
+		}
+	}
+
+	// internal iterative reduction, without a hash move the ordering is a guess, so spend less on it and
+	// let the shallower search leave a move in the table for the next visit
+	if (!ttMove && depth >= IIR_DEPTH && mPly && !mStack[mPly].excludedMove)
+	{
+		depth--;
+	}
+
+	// create move list instance, in check only the moves that can answer it
+	std::vector<Move> moves;
+	if (inCheck)
+	{
+		mModel.generateEvasions(moves);
+	}
+	else
+	{
+		mModel.generateMoves(moves);
+	}
+
+	// MultiPV, the moves of the lines already found are left out at the root
+	if (mPly == 0 && mExcludedRootMoves.size())
+	{
+		for (int count = moves.size() - 1; count >= 0; count--)
+		{
+			if (std::find(mExcludedRootMoves.begin(), mExcludedRootMoves.end(), moves[count]) != mExcludedRootMoves.end())
+			{
+				moves.erase(moves.begin() + count);
+			}
+		}
+	}
+
+	// the singular extension search leaves out the hash move
+	if (mStack[mPly].excludedMove)
+	{
+		for (int count = 0; count < moves.size(); count++)
+		{
+			if (pack_move(moves[count]) == mStack[mPly].excludedMove)
+			{
+				moves.erase(moves.begin() + count);
+				break;
+			}
+		}
+	}
+
+	// If we are on a PV line
+	if (mFollowPvLine)
+	{
+		EnablePvScoring(moves, mPly);
+	}
+
+	// sort the moves
+	OrderMoves(moves, mPly);
+
+	// off the PV line the hash move goes first
+	if (ttMove && !mFollowPvLine)
+	{
+		for (int count = 0; count < moves.size(); count++)
+		{
+			if (pack_move(moves[count]) == ttMove)
+			{
+				std::rotate(moves.begin(), moves.begin() + count, moves.begin() + count + 1);
+				break;
+			}
+		}
+	}
+
+	for (int count = 0; count < moves.size(); count++)
+	{
+		bool quietMove = decode_capture_flag(moves[count]) == 0 && decode_promoted_piece_type(moves[count]) == 0;
+
+		// late move pruning and history pruning, near the leaves the late quiet moves and those that keep failing
+		// elsewhere are dropped before they are made, there is a move searched already so mate can't be missed
+		if (!pvNode && !inCheck && mPly && quietMove && movesSearched > 0 && alpha > -45000 &&
+			mStack[mPly].killers[0] != moves[count] &&
+			mStack[mPly].killers[1] != moves[count])
+		{
+			if (depth <= LMP_DEPTH && movesSearched >= (LMP_BASE + depth * depth) / (improving ? 1 : 2))
+			{
+				continue;
+			}
+			if (depth <= HISTORY_PRUNING_DEPTH && QuietHistory(moves[count], mPly) < -HISTORY_PRUNING_MARGIN * depth)
+			{
+				continue;
+			}
+		}
+
+		// near the leaves a quiet move that just hangs material is not worth a search, unless it gives check
+		bool badQuiet = depth <= SEE_QUIET_DEPTH &&
+			mPly &&
+			movesSearched > 0 &&
+			inCheck == false &&
+			quietMove &&
+			mStack[mPly].killers[0] != moves[count] &&
+			mStack[mPly].killers[1] != moves[count] &&
+			StaticExchange(moves[count]) < -SEE_QUIET_MARGIN * depth;
+
+		// nor is one that can't bring a hopeless score back up to alpha
+		bool futileQuiet = futile && movesSearched > 0 && quietMove;
+
+		int reduction = LateMoveReduction(moves[count], depth, movesSearched, pvNode, improving, inCheck);
+
+		// depth left after the move, one more for a singular hash move
+		int newDepth = (singular && pack_move(moves[count]) == ttMove) ? depth : depth - 1;
+
+		// increment ply
+		SetCurrentMove(mPly, moves[count]);
+		mPly++;
+
+		// make the move
+		mModel.MakeMove(moves[count], allMoves);
+
+		// make sure to make only legal moves
+		if (mModel.IsIllegal())
+		{
+			// take back the move
+			mModel.UnmakeMove(moves[count]);
+			mPly--;
+
+			continue;
+		}
+
+		// increment the number of legal moves counted
+		legalMoves++;
+
+		if (badQuiet || futileQuiet)
+		{
+			unsigned long long opponentKing = (sideToMove == white) ? mModel.mBitboards[k] : mModel.mBitboards[K];
+			if (!mAttackTables->SquareAttacked(get_LS1B_index(opponentKing), sideToMove, mModel.mBitboards, mModel.mOccupancies))
+			{
+				mModel.UnmakeMove(moves[count]);
+				mPly--;
+				continue;
+			}
+		}
+
+		// full depth search
+		if (movesSearched == 0)
+		{
+			// score current move
+			score = -Negamax(-beta, -alpha, newDepth);
+		}
+		// Late Move Reduction (LMR) assume that the first handfull of moves are the best, search the rest with reduced depth
+		else
+		{
+			if (reduction)
+			{
+				// search move with a reduced depth
+				score = -Negamax(-alpha - 1, -alpha, newDepth - reduction);
+			}
+			else
+			{
+				// hack to ensure a full depth search is done
+				score = alpha + 1;
+			}
+
+			// PV search
+			if (score > alpha)
+			{
+				/* Once you've found a move with a score that is between alpha and beta,
+				* the rest of the moves are searched with the goal of proving that they are all bad.
+				* It's possible to do this a bit faster than a search that worries that one
+				* of the remaining moves might be good
+				*/
+
+				score = -Negamax(-alpha - 1, -alpha, newDepth);
+
+				/* If the algorithm finds out that it was wrong, and that one of the
+				* subsequent moves was better than the first PV move, it has to search again,
+				* in the normal alpha-beta manner. This happens sometimes, and it's a waste of time,
+				* but generally not often enough to counteract the savings gained from doing the
+				* "bad move proof" search referred to earlier.
+				*/
+
+				if ((score > alpha) && (score < beta))
+				{
+					score = -Negamax(-beta, -alpha, newDepth);
+				}
+			}
+		}
+
+		// decrement ply
+		mPly--;
+
+		// take move back
+		mModel.UnmakeMove(moves[count]);
+
+		// don't store or back up scores from an interrupted search
+		if (SearchAborted())
+		{
+			return 0;
+		}
+
+		// increment number of moves searched
+		movesSearched++;
+
+		// fail-hard beta cutoff
+		if (score >= beta)
+		{
+			// store transposition score with the BETA flag
+			RecordHash(score, depth, HASH_FLAG_BETA, moves[count]);
+
+			// move ordering statistics
+			mCutoffs++;
+			if (movesSearched == 1)
+			{
+				mFirstMoveCutoffs++;
+			}
+
+			if (!decode_capture_flag(moves[count]))
+			{
+				// store the killer, counter move and histories
+				UpdateQuietHistory(moves[count], quietsSearched, depth);
+				UpdateCaptureHistory(0, capturesSearched, depth);
+			}
+			else
+			{
+				UpdateCaptureHistory(moves[count], capturesSearched, depth);
+			}
+			// move fails high
+			return beta;
+		}
+
+		if (score > alpha)
+		{
+			// switch to exact flag
+			hashf = HASH_FLAG_EXACT;
+
+			// PV move
+			alpha = score;
+			bestMove = moves[count];
+
+			// write PV move
+			PvLine(mPly)[mPly] = moves[count];
+
+			// copy the line from the deeper ply in behind it
+			std::copy(PvLine(mPly + 1) + mPly + 1, PvLine(mPly + 1) + mPvLength[mPly + 1], PvLine(mPly) + mPly + 1);
+
+			// adjust PV length
+			mPvLength[mPly] = mPvLength[mPly + 1];
+		}
+
+		// moves that didn't cut off, penalised if a later one does
+		if (!decode_capture_flag(moves[count]))
+		{
+			quietsSearched.push_back(moves[count]);
+		}
+		else
+		{
+			capturesSearched.push_back(moves[count]);
+		}
+
+		// Young Brothers Wait: with the eldest brother searched, idle threads can take the rest of the moves
+		if (mSmpMode == youngBrothersWait &&
+			depth >= SPLIT_MIN_DEPTH &&
+			count + 1 < moves.size() &&
+			mMainThread->mIdleHelpers.load(std::memory_order_relaxed) > 0)
+		{
+			Move splitMove = 0;
+			score = Split(moves, count + 1, alpha, beta, depth, inCheck, splitMove);
+
+			if (SearchAborted())
+			{
+				return 0;
+			}
+
+			if (score >= beta)
+			{
+				RecordHash(beta, depth, HASH_FLAG_BETA, splitMove);
+				mCutoffs++;
+
+				if (!decode_capture_flag(splitMove))
+				{
+					UpdateQuietHistory(splitMove, quietsSearched, depth);
+					UpdateCaptureHistory(0, capturesSearched, depth);
+				}
+				else
+				{
+					UpdateCaptureHistory(splitMove, capturesSearched, depth);
+				}
+				return beta;
+			}
+
+			if (score > alpha)
+			{
+				hashf = HASH_FLAG_EXACT;
+				alpha = score;
+				bestMove = splitMove;
+			}
+			break;
+		}
+	}
+
+
+	// store the hash
+	RecordHash(alpha, depth, hashf, bestMove);
+
+	// check if stalemate or checkmate
+	if (legalMoves == 0)
+	{
+		// only the excluded move was left, that says nothing about the position
+		if (mStack[mPly].excludedMove)
+		{
+			return alpha;
+		}
+
+		if (inCheck)
+		{
+			// checkmate
+			RecordHash(-49000, depth, HASH_FLAG_EXACT, 0);
+			return -49000 + mPly;
+		}
+		else
+		{
+			// stalemate
+			RecordHash(0, depth, HASH_FLAG_EXACT, 0);
+			return 0;
+		}
+	}
+
+	// move fails low
+	return alpha;
+}
+
+int SearchThread::QuiescenceNegamax(int alpha, int beta, int depth)
+{
+	mNodes++;
+
+	if ((mNodes & (NODE_CHECK_INTERVAL - 1)) == 0)
+	{
+		mMainThread->CheckLimits(NODE_CHECK_INTERVAL);
+	}
+
+	int score;
+	if ((score = ProbeHash(alpha, beta, depth)) != NO_HASH_ENTRY)
+	{
+		// return the value if the position has been searched before
+		//std::cout << "here" << std::endl;
+
+		if (score == 49000)
+			return score - mPly;
+		if (score == -49000)
+			return score + mPly;
+
+		return score;
+	}
+
+	// the search stack ends at MAX_PLY
+	if (mPly >= MAX_PLY - 1)
+	{
+		return mAgent->Evaluate(mModel);
+	}
+
+	// in check standing pat isn't an option, every evasion gets searched
+	int sideToMove = mModel.mSideToMove;
+	unsigned long long kingBitboard = (sideToMove == white) ? mModel.mBitboards[K] : mModel.mBitboards[k];
+	int inCheck = mAttackTables->SquareAttacked(get_LS1B_index(kingBitboard), sideToMove ^ 1,
+		mModel.mBitboards, mModel.mOccupancies);
+
+	int standingPat = 0;
+	if (!inCheck)
+	{
+		// evaluate position
+		standingPat = mAgent->Evaluate(mModel);
+		// fail-hard beta cutoff
+		if (standingPat >= beta)
+		{
+			return beta;
+		}
+
+		if (standingPat > alpha)
+		{
+			alpha = standingPat;
+		}
+
+		// delta pruning, not even winning a queen gets us back to alpha (unless a pawn is about to promote)
+		unsigned long long promotingPawns = sideToMove == white ? mModel.mBitboards[P] & RANK7 : mModel.mBitboards[p] & RANK2;
+		if (!promotingPawns && standingPat + abs(material_score[Q]) + QS_DELTA_MARGIN < alpha)
+		{
+			return alpha;
+		}
+	}
+
+	// create move list instance, in check only the moves that can answer it
+	std::vector<Move> moves;
+	if (inCheck)
+	{
+		mModel.generateEvasions(moves);
+	}
+	else
+	{
+		mModel.generateMoves(moves);
+	}
+
+	// sort the moves
+	OrderMoves(moves, mPly);
+
+	// count the legal moves, in check none means mate
+	int legalMoves = 0;
+
+	for (int count = 0; count < moves.size(); count++)
+	{
+		// out of check only captures and promotions are searched, and not all of those
+		if (!inCheck)
+		{
+			// skip non-capture moves
+			if (!decode_capture_flag(moves[count]) && !decode_promoted_piece_type(moves[count]))
+			{
+				continue;
+			}
+
+			// skip captures that lose material once every recapture is played
+			if (decode_capture_flag(moves[count]) && StaticExchange(moves[count]) < 0)
+			{
+				continue;
+			}
+
+			// futility, even the piece taken leaves the score short of alpha
+			if (!decode_promoted_piece_type(moves[count]) &&
+				standingPat + abs(material_score[CapturedPiece(moves[count])]) + QS_FUTILITY_MARGIN <= alpha)
+			{
+				continue;
+			}
+		}
+
+
+		// increment ply
+		SetCurrentMove(mPly, moves[count]);
+		mPly++;
+
+		// make the move
+		mModel.MakeMove(moves[count], allMoves);
+
+		// make sure to make only legal moves
+		if (mModel.IsIllegal())
+		{
+			// take back the move
+			mModel.UnmakeMove(moves[count]);
+			mPly--;
+
+			continue;
+		}
+		legalMoves++;
+
+		// score current move
+		score = -QuiescenceNegamax(-beta, -alpha, depth - 1);
+
+		// decremetn ply
+		mPly--;
+
+		// take move back
+		mModel.UnmakeMove(moves[count]);
+
+		if (SearchAborted())
+		{
+			return 0;
+		}
+
+		// fail-hard beta cutoff
+		if (score >= beta)
+		{
+			// move fails high
+			return beta;
+		}
+
+		if (score > alpha)
+		{
+			// PV move
+			alpha = score;
+		}
+	}
+
+	// checkmate
+	if (inCheck && legalMoves == 0)
+	{
+		return -49000 + mPly;
+	}
+
+	// move fails low
+	return alpha;
+}
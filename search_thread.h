@@ -0,0 +1,372 @@
+#pragma once
+
+#include "model.h"
+#include "helper.h"
+#include "defs.h"
+#include "zobrist.h"
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+// deepest ply a search can reach, sizes the search stack and the PV, and so limits the iteration depth
+const int MAX_PLY = 128;
+
+// upper limit for the UCI "Threads" option
+const int MAX_THREADS = 32;
+
+// nodes closer to the leaves than this are not split between threads
+const int SPLIT_MIN_DEPTH = 4;
+
+// parallel search modes for the UCI "SMP" option
+enum {
+	lazySmp, youngBrothersWait
+};
+
+// time kept back on every move for the GUI and the network, in ms
+const int MOVE_OVERHEAD = 50;
+
+// moves left in the game when the GUI doesn't send movestogo
+const int DEFAULT_MOVES_TO_GO = 30;
+
+// time for a move when nothing bounds the search, e.g. the GUI only sends the opponent's clock, in ms
+const int DEFAULT_MOVE_TIME = 5000;
+
+// nodes between two looks at the clock and the node budget
+const int NODE_CHECK_INTERVAL = 2048;
+
+// upper limit for the UCI "MultiPV" option
+const int MAX_MULTI_PV = 64;
+
+// iterations from this depth on start with a window this wide either side of the last score, doubled after every fail
+const int ASPIRATION_MIN_DEPTH = 4;
+const int ASPIRATION_WINDOW = 50;
+
+// this close to the leaves, quiet moves that lose more than the margin per ply of depth to the static exchange are skipped
+const int SEE_QUIET_DEPTH = 3;
+const int SEE_QUIET_MARGIN = 60;
+
+// quiescence: a capture has to be able to lift the stand pat this close to alpha, the node as a whole within a queen and the margin
+const int QS_FUTILITY_MARGIN = 200;
+const int QS_DELTA_MARGIN = 200;
+
+// frontier (depth 1) and extended (depth 2) futility, quiet moves can't make up more than this
+const int FUTILITY_MARGIN[3] = { 0, 300, 500 };
+
+// reverse futility, a static eval this far above beta per ply of depth left is taken as a fail-high
+const int REVERSE_FUTILITY_DEPTH = 3;
+const int REVERSE_FUTILITY_MARGIN = 120;
+
+// quiet move histories saturate at this value, a cutoff earns depth squared times the scale up to the cap
+const int HISTORY_MAX = 16384;
+const int HISTORY_BONUS_SCALE = 32;
+const int HISTORY_BONUS_MAX = 1200;
+
+// null move pruning from this depth on, the reply is searched NULL_MOVE_REDUCTION plies shallower, one more
+// for every NULL_MOVE_DEPTH_DIVISOR plies of depth and every NULL_MOVE_EVAL_DIVISOR the static eval is above beta
+const int NULL_MOVE_DEPTH = 3;
+const int NULL_MOVE_REDUCTION = 2;
+const int NULL_MOVE_DEPTH_DIVISOR = 4;
+const int NULL_MOVE_EVAL_DIVISOR = 200;
+const int NULL_MOVE_MAX_EVAL_REDUCTION = 3;
+
+// a null move cutoff is checked by a search without null moves this deep, or when the side to move has this few pieces
+const int NULL_MOVE_VERIFY_DEPTH = 10;
+const int NULL_MOVE_VERIFY_PIECES = 2;
+
+// singular extensions from this depth on, for a hash move with a lower bound at most SINGULAR_TT_DEPTH plies shallower,
+// it is extended when the other moves searched to half depth all stay SINGULAR_MARGIN per ply below its score
+const int SINGULAR_DEPTH = 6;
+const int SINGULAR_TT_DEPTH = 3;
+const int SINGULAR_MARGIN = 2;
+
+// late move pruning, near the leaves the quiet moves after the first (LMP_BASE + depth * depth) / 2 are skipped,
+// twice as many are searched while the static eval is improving
+const int LMP_DEPTH = 4;
+const int LMP_BASE = 3;
+
+// history pruning, near the leaves a quiet move whose history is below -HISTORY_PRUNING_MARGIN per ply is skipped
+const int HISTORY_PRUNING_DEPTH = 4;
+const int HISTORY_PRUNING_MARGIN = 2048;
+
+// static eval kept for a ply that was in check
+const int NO_EVAL = -100000;
+
+// ProbCut, from this depth on a capture that wins enough to clear beta by the margin in quiescence and then in a search
+// PROBCUT_REDUCTION plies shallower is taken as proof that the full search would fail high as well
+const int PROBCUT_DEPTH = 5;
+const int PROBCUT_MARGIN = 200;
+const int PROBCUT_REDUCTION = 4;
+
+// internal iterative reduction, a node this deep without a hash move is searched a ply shallower
+const int IIR_DEPTH = 4;
+
+// late move reductions, LMR_BASE + ln(depth) * ln(move number) / LMR_DIVISOR plies for the quiet moves after
+// the first few, one less on the PV and one less per LMR_HISTORY_DIVISOR of quiet history
+const int LMR_MAX_MOVES = 64;
+const double LMR_BASE = 0.75;
+const double LMR_DIVISOR = 2.25;
+const int LMR_HISTORY_DIVISOR = 8192;
+
+// capture history is divided down by this before it is added to MVV LVA, keeping it mostly within one victim
+const int CAPTURE_HISTORY_DIVISOR = 128;
+
+// how the soft time limit follows the root from one iteration to the next, factors are in percent
+struct TimePolicy
+{
+	// off keeps the soft limit at a fixed fraction of the clock
+	bool adaptive;
+
+	// the best move survived this many iterations in a row, spend less
+	int stableIterations;
+	int stableFactor;
+
+	// the best move changed in the last iteration, spend more
+	int instabilityFactor;
+
+	// the score fell by more than the margin since the last iteration, spend more
+	int scoreDropMargin;
+	int scoreDropFactor;
+};
+
+const TimePolicy DEFAULT_TIME_POLICY = { true, 3, 50, 150, 30, 150 };
+
+// one root move and the line played after it
+struct SearchLine
+{
+	int score;
+	std::vector<Move> pv;
+};
+
+// the last iteration a search completed
+struct SearchResult
+{
+	Move bestMove;
+	int score;
+	int depth;
+	unsigned long long nodes;
+	std::vector<Move> pv;
+
+	// the best MultiPV lines, best first, the first one is the move and pv above
+	std::vector<SearchLine> lines;
+
+	// root searches repeated because the score fell outside the aspiration window, over the whole search
+	int failHighs;
+	int failLows;
+
+	// beta cutoffs and how many of them came from the first move searched, over the whole search
+	unsigned long long cutoffs;
+	unsigned long long firstMoveCutoffs;
+};
+
+// what the search keeps about one ply of the line it is on
+struct SearchStack
+{
+	// static evaluation of the position, NO_EVAL when in check
+	int staticEval;
+	bool inCheck;
+
+	// the move made from the position, zero for a null move, and the move a singular extension search leaves out
+	Move currentMove;
+	PackedMove excludedMove;
+
+	Move killers[2];
+
+	// continuation history of the move made, [piece][to] of the move one and two plies later
+	short (*continuationHistory[2])[64];
+};
+
+class Agent;
+class SearchThread;
+struct TT_Entry;
+
+// a node whose remaining moves are shared out to idle threads (Young Brothers Wait)
+struct SplitPoint
+{
+	SplitPoint(Model const& node) : position(node) {}
+
+	// the position at the node, copied by every thread that joins
+	Model position;
+	SplitPoint* parent;
+	SearchThread* owner;
+
+	// the node's ordered moves, every thread that joins takes the next one under the split point's lock
+	std::vector<Move> moves;
+	int nextMove;
+
+	int alpha;
+	int beta;
+	int depth;
+	int ply;
+	int currentDepthStart;
+	int inCheck;
+
+	// null-move verification bound of the owner, below it null moves stay off
+	int nullMoveMinPly;
+
+	// the search stack from the root down to the node
+	std::vector<SearchStack> stack;
+
+	// best move and its line below the split point
+	Move bestMove;
+	std::vector<Move> pv;
+
+	// threads working on the split point, the owner included
+	int workers;
+
+	// raised on a fail-high so that the other threads stop searching their moves
+	std::atomic<bool> cutoff;
+	std::mutex lock;
+};
+
+// everything one search needs for itself, the agent only lends it the evaluation and the transposition table
+class SearchThread
+{
+public:
+	SearchThread(Agent* agent);
+
+	void SetPosition(Model const& model, std::unordered_map<unsigned long long, int> const& movesHistory);
+	void LoadPosition(std::string FEN);
+	void SetHelpers(std::vector<SearchThread*> const& helpers, int smpMode);
+	void SetStopFlag(std::atomic<bool>* stop);
+	void SetPonderHitFlag(std::atomic<bool>* ponderHit);
+	void SetTimePolicy(TimePolicy const& policy);
+	void SetMultiPv(int lines);
+	unsigned long long GetNodes() { return mNodes; };
+
+	void PrintMoveScores(std::vector<Move> const& moves, int depth);
+	int scoreMove(Move move, int depth);
+	void OrderMoves(std::vector<Move>& moves, int depth);
+	int StaticExchange(Move move);
+	int CapturedPiece(Move move);
+
+	void SetCurrentMove(int ply, Move move);
+	bool Improving();
+	int QuietHistory(Move move, int ply);
+	int LateMoveReduction(Move move, int depth, int moveNumber, bool pvNode, bool improving, int inCheck);
+	void UpdateQuietHistory(Move bestMove, std::vector<Move> const& quietsSearched, int depth);
+	void UpdateCaptureHistory(Move bestMove, std::vector<Move> const& capturesSearched, int depth);
+
+	void ResetKilleHistoryMoves();
+	void ResetKillerMoves();
+	void ResetPVMoves();
+
+	int CountLegalMoves();
+	bool ReadHash(TT_Entry& entry);
+	int ProbeHash(int alpha, int beta, int depth);
+	void RecordHash(int score, int depth, int hashFlag, Move move);
+
+	void EnablePvScoring(std::vector<Move> const& moves, int ply);
+
+	SearchResult SearchNegamax(SearchLimits const& limits);
+	SearchResult Analyse(SearchLimits const& limits, bool printInfo);
+	void SetTimeLimits(SearchLimits const& limits);
+	void AdjustTimeLimit(int stableIterations, bool bestMoveChanged, int scoreDrop);
+	unsigned long long ElapsedTime();
+	bool Pondering();
+	// called on the main thread's object by every thread of the search, with the nodes searched since the last call
+	void CheckLimits(unsigned long long nodes);
+	int Negamax(int alpha, int beta, int depth);
+	int QuiescenceNegamax(int alpha, int beta, int depth);
+
+	// Lazy SMP
+	void StartHelpers();
+	unsigned long long StopHelpers();
+	void HelperSearch(int threadIndex);
+
+	// Young Brothers Wait
+	void HelperIdleLoop();
+	SplitPoint* StealSplitPoint();
+	int Split(std::vector<Move> const& moves, int firstMove, int alpha, int beta, int depth, int inCheck, Move& bestMove);
+	void SearchSplitPoint(SplitPoint* sp);
+	bool SearchAborted();
+
+	Model mModel;
+
+private:
+	Agent* mAgent;
+	AttackTables* mAttackTables;
+	Zobrist* mZobristTables;
+
+	// shared with every other thread of the agent
+	TT_Entry* mHashTable;
+	unsigned long long mTTSize;
+
+	unsigned long long mNodes;
+
+	// nodes of every thread of the search, for the node limit, on the main thread
+	std::atomic<unsigned long long> mSearchNodes;
+
+	unsigned long long mCutoffs;
+	unsigned long long mFirstMoveCutoffs;
+	bool mFollowPvLine;
+	bool mScorePV;
+	int mPly;
+	int mCurrentDepthStart;
+
+	// no null moves above this ply while a null move cutoff is verified
+	int mNullMoveMinPly;
+
+	// only set while Analyse runs, time limits are in ms from mStartTime and zero when unlimited,
+	// the helpers read them through CheckLimits
+	SearchLimits mLimits;
+	std::atomic<unsigned long long> mStartTime;
+	unsigned long long mSoftTimeLimit;
+	unsigned long long mHardTimeLimit;
+
+	// the soft limit before the policy scales it
+	unsigned long long mBaseTimeLimit;
+	TimePolicy mTimePolicy;
+
+	// while pondering the time limits wait for "ponderhit", which the UCI thread signals through the flag
+	std::atomic<bool> mPondering;
+	std::atomic<bool> mPonderHit;
+	std::atomic<bool>* mPonderHitSignal;
+
+	// per ply state of the current line, allocated with the thread
+	SearchStack mStack[MAX_PLY];
+
+	// late move reductions by [depth][move number]
+	int mReductions[MAX_PLY][LMR_MAX_MOVES];
+
+	// quiet move ordering: [side][from][to], the reply to [piece][to] of the last move,
+	// and [piece][to] of the move one and two plies back by [piece][to]
+	int mButterflyHistory[2][64][64];
+	Move mCounterMoves[12][64];
+	short mContinuationHistory[2][12][64][12][64];
+
+	// capture ordering on top of MVV LVA: [piece][to][captured piece type]
+	short mCaptureHistory[12][64][6];
+
+	// the line found at every ply, in MAX_PLY slots per ply of one flat table and indexed by ply from the root
+	int mPvLength[MAX_PLY];
+	Move mPvTable[MAX_PLY * MAX_PLY];
+	Move* PvLine(int ply) { return &mPvTable[ply * MAX_PLY]; }
+
+	std::unordered_map<unsigned long long, int> mMoveHashesHistory;
+
+	// MultiPV, each line searches the root again without the moves of the lines before it
+	int mMultiPv;
+	std::vector<Move> mExcludedRootMoves;
+
+	// helper threads searching the same root, only set on the thread that owns the search
+	std::vector<SearchThread*> mHelpers;
+	std::vector<std::thread> mHelperThreads;
+
+	// raised by the main thread to end a search, helpers point at the main thread's flag
+	std::atomic<bool> mStopSearch;
+	std::atomic<bool>* mStop;
+
+	// split point search state, every thread publishes its own split points for the others to steal,
+	// the idle count is only used on the main thread
+	int mSmpMode;
+	SearchThread* mMainThread;
+	SplitPoint* mActiveSplit;
+	std::mutex mSplitLock;
+	std::vector<SplitPoint*> mSplitPoints;
+	std::atomic<int> mIdleHelpers;
+	int mNextVictim;
+};
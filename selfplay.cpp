@@ -0,0 +1,155 @@
+#include "selfplay.h"
+
+#include <chrono>
+
+// balanced openings, every one is played with both colours
+const std::vector<std::string> selfPlayOpenings = {
+	"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+	"r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+	"rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+	"rnbqkb1r/ppp1pppp/5n2/3p4/2PP4/8/PP2PPPP/RNBQKBNR w KQkq - 1 3",
+	"rnbqkbnr/pp2pppp/2p5/3p4/3PP3/8/PPP2PPP/RNBQKBNR w KQkq - 0 3",
+	"r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+	"rnbqk2r/ppp1ppbp/3p1np1/8/2PPP3/2N5/PP3PPP/R1BQKBNR w KQkq - 0 5",
+	"rnbqkb1r/pppp1ppp/4pn2/8/2PP4/8/PP2PPPP/RNBQKBNR w KQkq - 0 3",
+};
+
+// longer games are called a draw
+const int SELF_PLAY_MAX_PLIES = 300;
+
+int PlaySelfPlayGame(Environment* env, Agent* adaptive, Agent* fixed, std::string FEN, int adaptiveSide,
+	unsigned long long time, unsigned long long increment, unsigned long long* timeUsed, std::string& reason)
+{
+	env->LoadPosition(FEN);
+
+	// both sides start with the same clock
+	long long clock[2] = { (long long)time, (long long)time };
+
+	for (int ply = 0; ply < SELF_PLAY_MAX_PLIES; ply++)
+	{
+		int side = env->mModel.GetSideToMove();
+		Agent* player = side == adaptiveSide ? adaptive : fixed;
+
+		SearchLimits limits = {};
+		limits.time[white] = clock[white];
+		limits.time[black] = clock[black];
+		limits.increment[white] = increment;
+		limits.increment[black] = increment;
+
+		// search quietly on one of the player's threads, the way SearchNegamax would
+		player->UpdateFromPercepts(env->GetPercepts());
+		player->ClearTranspositionTable();
+		SearchThread* thread = player->AcquireSearchThread();
+		thread->SetPosition(player->mModel, env->mMoveHashesHistory);
+
+		unsigned long long time_start = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		SearchResult result = player->RunSearch(thread, {}, limits, false);
+		unsigned long long time_end = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		player->ReleaseSearchThread(thread);
+
+		// charge the clock, flagging loses
+		timeUsed[side] += time_end - time_start;
+		clock[side] -= time_end - time_start;
+		if (clock[side] <= 0)
+		{
+			reason = "time";
+			return side == adaptiveSide ? selfPlayLoss : selfPlayWin;
+		}
+		clock[side] += increment;
+
+		env->MakeMove(result.bestMove);
+
+		// 50 move rule, stalemate and checkmate
+		int endCondition = env->mModel.CheckDrawOrCheckmateOrInPlay(env->mZobristTables);
+		if (endCondition == checkmate)
+		{
+			reason = "checkmate";
+			return side == adaptiveSide ? selfPlayWin : selfPlayLoss;
+		}
+		if (endCondition == draw)
+		{
+			reason = "stalemate or 50 moves";
+			return selfPlayDraw;
+		}
+
+		// 3-fold repitition
+		int count = 0;
+		for (int i = 0; i < env->mHashRepititionList.size(); i++)
+		{
+			if (env->mHashRepititionList[i] == env->mModel.GetHash())
+			{
+				count++;
+			}
+		}
+		if (count >= 3)
+		{
+			reason = "repetition";
+			return selfPlayDraw;
+		}
+	}
+	reason = "move limit";
+	return selfPlayDraw;
+}
+
+int SelfPlayMain(Zobrist* zTables, int argc, char* argv[])
+{
+	int games = selfPlayOpenings.size() * 2;
+	unsigned long long time = 10000;
+	unsigned long long increment = 100;
+
+	// parse the arguments
+	for (int i = 0; i + 1 < argc; i += 2)
+	{
+		std::string argument = argv[i];
+		if (argument == "games")
+		{
+			games = atoi(argv[i + 1]);
+		}
+		else if (argument == "time")
+		{
+			time = strtoull(argv[i + 1], NULL, 10);
+		}
+		else if (argument == "inc")
+		{
+			increment = strtoull(argv[i + 1], NULL, 10);
+		}
+	}
+
+	Environment env(zTables);
+	Agent adaptive(zTables);
+	Agent fixed(zTables);
+
+	// the sides differ only in the adaptive switch
+	TimePolicy policy = DEFAULT_TIME_POLICY;
+	adaptive.SetTimePolicy(policy);
+	policy.adaptive = false;
+	fixed.SetTimePolicy(policy);
+
+	int results[3] = { 0, 0, 0 };
+	unsigned long long adaptiveTime = 0;
+	unsigned long long fixedTime = 0;
+
+	for (int game = 0; game < games; game++)
+	{
+		// every opening twice, once with each colour
+		std::string FEN = selfPlayOpenings[(game / 2) % selfPlayOpenings.size()];
+		int adaptiveSide = game % 2 == 0 ? white : black;
+
+		unsigned long long timeUsed[2] = { 0, 0 };
+		std::string reason;
+		int result = PlaySelfPlayGame(&env, &adaptive, &fixed, FEN, adaptiveSide, time, increment, timeUsed, reason);
+		results[result]++;
+		adaptiveTime += timeUsed[adaptiveSide];
+		fixedTime += timeUsed[adaptiveSide ^ 1];
+
+		const char* resultNames[3] = { "loss", "draw", "win" };
+		std::cout << "game " << game + 1 << " adaptive " << (adaptiveSide == white ? "white" : "black") << " " << resultNames[result] <<
+			" by " << reason << " plies " << env.mMovesMade.size() << " time adaptive " << timeUsed[adaptiveSide] << " fixed " << timeUsed[adaptiveSide ^ 1] << std::endl;
+	}
+
+	// score from the adaptive side, a win is one point and a draw half
+	std::cout << "adaptive +" << results[selfPlayWin] << " =" << results[selfPlayDraw] << " -" << results[selfPlayLoss] <<
+		" score " << (results[selfPlayWin] * 2 + results[selfPlayDraw]) * 50 / std::max(1, games) << "%" <<
+		" time adaptive " << adaptiveTime << " fixed " << fixedTime << std::endl;
+	return 0;
+}
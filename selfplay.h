@@ -0,0 +1,19 @@
+#pragma once
+#include "agent.h"
+#include "environment.h"
+#include "search_thread.h"
+
+#include <string>
+#include <vector>
+
+// results from the adaptive engine's point of view
+enum {
+	selfPlayLoss, selfPlayDraw, selfPlayWin
+};
+
+// plays one game, the adaptive agent takes the side given, returns the result for it
+int PlaySelfPlayGame(Environment* env, Agent* adaptive, Agent* fixed, std::string FEN, int adaptiveSide,
+	unsigned long long time, unsigned long long increment, unsigned long long* timeUsed, std::string& reason);
+
+// "selfplay [games N] [time ms] [inc ms]" from the command line
+int SelfPlayMain(Zobrist* zTables, int argc, char* argv[]);
@@ -1,8 +1,8 @@
 #include "uci.h"
 
-unsigned long long Book(Environment* env, Agent* agent)
+Move Book(Environment* env, Agent* agent)
 {
-	unsigned long long move;
+	Move move;
 	if (agent->mModel.mHash == 0x9f8c3d6078abf32e)
 	{
 		move = encode_move(d2, d4, P, 0, 0, 1, 0, 0);
@@ -77,8 +77,43 @@ unsigned long long Book(Environment* env, Agent* agent)
 	return move;
 }
 
+void SearchAndReport(Environment* env, Agent* agent, SearchLimits limits)
+{
+	// opening book, but not while pondering where the GUI waits for "ponderhit" or "stop"
+	SearchResult result = {};
+	if (!limits.ponder)
+	{
+		result.bestMove = Book(env, agent);
+	}
+	if (!result.bestMove)
+	{
+		result = agent->SearchNegamax(limits);
+	}
+
+	// the reply we expect from the PV, for the GUI to start our next ponder search on
+	std::string bestMove = "bestmove " + moveToString(result.bestMove);
+	if (result.pv.size() >= 2)
+	{
+		bestMove += " ponder " + moveToString(result.pv[1]);
+	}
+	std::cout << bestMove + "\n" << std::flush;
+}
+
+void StopSearchThread(Agent* agent, std::thread& searchThread)
+{
+	// end the search early and wait for its bestmove
+	if (searchThread.joinable())
+	{
+		agent->StopSearch();
+		searchThread.join();
+	}
+	agent->ClearStop();
+}
+
 void UCILoop(Environment *env, Agent* agent)
 {
+	// searches run here so that we keep reading commands while thinking
+	std::thread searchThread;
 	
 	setvbuf(stdin, NULL, _IONBF, 0);
 	setvbuf(stdout, NULL, _IONBF, 0);
@@ -89,6 +124,11 @@ void UCILoop(Environment *env, Agent* agent)
 	// print identifying info
 	std::cout << "id name WolfTacticsV1" << std::endl;
 	std::cout << "id author Greg Schmidt" << std::endl;
+	std::cout << "option name Threads type spin default 1 min 1 max " << MAX_THREADS << std::endl;
+	std::cout << "option name SMP type combo default LazySMP var LazySMP var YBWC" << std::endl;
+	std::cout << "option name AdaptiveTime type check default true" << std::endl;
+	std::cout << "option name Ponder type check default false" << std::endl;
+	std::cout << "option name MultiPV type spin default 1 min 1 max " << MAX_MULTI_PV << std::endl;
 	std::cout << "uciok" << std::endl;
 
 	// main loop
@@ -103,7 +143,9 @@ void UCILoop(Environment *env, Agent* agent)
 		// get user/GUI input
 		if (!fgets(input, 2000, stdin))
 		{
-			continue;
+			// input closed, "stop" can't arrive any more so an infinite or ponder search is stopped like on "quit"
+			StopSearchThread(agent, searchThread);
+			break;
 		}
 
 		// make sure input is available
@@ -121,6 +163,7 @@ void UCILoop(Environment *env, Agent* agent)
 
 		else if (strncmp(input, "position", 8) == 0)
 		{
+			StopSearchThread(agent, searchThread);
 			env->ParsePosition(input);
 			env->PrintBoard();
 
@@ -132,9 +175,41 @@ void UCILoop(Environment *env, Agent* agent)
 		else if (strncmp(input, "ucinewgame", 10) == 0)
 		{
 			// TODO make reset to start position
+			StopSearchThread(agent, searchThread);
 			env->ParsePosition("position startpos");
 			env->PrintBoard();
 		}
+		else if (strncmp(input, "setoption", 9) == 0)
+		{
+			StopSearchThread(agent, searchThread);
+
+			// parse "setoption name Threads value N"
+			const char* value = strstr(input, "value");
+			if (strstr(input, "name Threads") && value)
+			{
+				agent->SetThreads(atoi(value + 6));
+			}
+
+			// "setoption name SMP value LazySMP|YBWC"
+			if (strstr(input, "name SMP") && value)
+			{
+				agent->SetSmpMode(strncmp(value + 6, "YBWC", 4) == 0 ? youngBrothersWait : lazySmp);
+			}
+
+			// "setoption name AdaptiveTime value true|false"
+			if (strstr(input, "name AdaptiveTime") && value)
+			{
+				TimePolicy policy = DEFAULT_TIME_POLICY;
+				policy.adaptive = strncmp(value + 6, "false", 5) != 0;
+				agent->SetTimePolicy(policy);
+			}
+
+			// "setoption name MultiPV value N"
+			if (strstr(input, "name MultiPV") && value)
+			{
+				agent->SetMultiPv(atoi(value + 6));
+			}
+		}
 		else if (strncmp(input, "option", 6) == 0)
 		{
 			std::cout << "uciok" << std::endl;
@@ -142,24 +217,28 @@ void UCILoop(Environment *env, Agent* agent)
 
 		else if (strncmp(input, "go", 2) == 0)
 		{
-			// opening book
-			unsigned long long move;
-			move = Book(env, agent);
-			if (!move)
-			{
-				int depth = env->ParseGoDepth(input);
-				move = agent->SearchNegamax(depth);
-			}
+			StopSearchThread(agent, searchThread);
+
+			// the search thread prints bestmove when it is done
+			SearchLimits limits = env->ParseGo(input);
+			searchThread = std::thread(SearchAndReport, env, agent, limits);
+		}
 
-			std::cout << "bestmove ";
-			printMove(move);
-			std::cout << std::endl;
-			
+		else if (strncmp(input, "stop", 4) == 0)
+		{
+			StopSearchThread(agent, searchThread);
+		}
+
+		else if (strncmp(input, "ponderhit", 9) == 0)
+		{
+			// the ponder search keeps going, now on our own clock
+			agent->PonderHit();
 		}
 
 		else if (strncmp(input, "quit", 4) == 0)
 		{
 			// break out
+			StopSearchThread(agent, searchThread);
 			break;
 		}
 
@@ -169,6 +248,11 @@ void UCILoop(Environment *env, Agent* agent)
 			// print identifying info
 			std::cout << "id name WolfTacticsV1" << std::endl;
 			std::cout << "id author Greg Schmidt" << std::endl;
+			std::cout << "option name Threads type spin default 1 min 1 max " << MAX_THREADS << std::endl;
+			std::cout << "option name SMP type combo default LazySMP var LazySMP var YBWC" << std::endl;
+			std::cout << "option name AdaptiveTime type check default true" << std::endl;
+			std::cout << "option name Ponder type check default false" << std::endl;
+			std::cout << "option name MultiPV type spin default 1 min 1 max " << MAX_MULTI_PV << std::endl;
 			std::cout << "uciok" << std::endl;
 		}
 	}
@@ -3,4 +3,10 @@
 #include "agent.h"
 #include "helper.h"
 
+#include <thread>
+
+void SearchAndReport(Environment* env, Agent* agent, SearchLimits limits);
+
+void StopSearchThread(Agent* agent, std::thread& searchThread);
+
 void UCILoop(Environment *env, Agent * agent);
\ No newline at end of file